@@ -0,0 +1,154 @@
+#ifndef __ADC_FRAME_H__
+#define __ADC_FRAME_H__
+
+#include "stm32f1xx_hal.h"
+#include "hardware_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *                              类型定义
+ ******************************************************************************/
+
+/**
+ * @brief ADC扫描帧内的通道序号
+ * @note  顺序即 ADC1 规则组的 Rank 顺序，也是 DMA 缓冲中每帧的排列顺序。
+ *        通道号来自 hardware_config.h 的 ADC 通道规划。
+ */
+typedef enum
+{
+    ADC_FRAME_MOTOR1_CURRENT = 0,   ///< CH0  PA0
+    ADC_FRAME_MOTOR2_CURRENT,       ///< CH1  PA1
+    ADC_FRAME_MOTOR3_CURRENT,       ///< CH2  PA2
+    ADC_FRAME_MOTOR4_CURRENT,       ///< CH3  PA3
+    ADC_FRAME_MOTOR5_CURRENT,       ///< CH4  PA4
+    ADC_FRAME_MOTOR6_CURRENT,       ///< CH5  PA5
+    ADC_FRAME_NTC1,                 ///< CH8  PB0
+    ADC_FRAME_NTC2,                 ///< CH9  PB1
+    ADC_FRAME_HEAT_CURRENT1,        ///< CH10 PC0
+    ADC_FRAME_HEAT_CURRENT2,        ///< CH11 PC1
+    ADC_FRAME_FAN1_CURRENT,         ///< CH12 PC2
+    ADC_FRAME_FAN2_CURRENT,         ///< CH13 PC3
+    ADC_FRAME_VREFINT,              ///< CH17 内部参考，用于测 VDDA
+    ADC_FRAME_CH_NUM
+} adc_frame_ch_t;
+
+/**
+ * @brief 帧回调函数类型
+ * @param frame: 刚完成的一整帧采样（ADC_FRAME_CH_NUM 个值，电流类通道已按 Vrefint 补偿）
+ * @note  在 DMA 中断里调用，回调必须短小、不可阻塞
+ */
+typedef void (*adc_frame_hook_t)(const uint16_t *frame);
+
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+
+/* 单通道转换周期 = 采样 239.5 + 转换 12.5 = 252 个ADC时钟 */
+#define ADC_FRAME_CONV_CYCLES   252U
+/* ADC时钟 = PCLK2 / 6 = 12MHz（见 SystemClock_Config） */
+#define ADC_FRAME_ADC_CLK_HZ    (SYSTEM_CLOCK_FREQ / 6U)
+/* 整帧速率（约 3663Hz），所有帧流消费者按此速率被调用 */
+#define ADC_FRAME_RATE_HZ       (ADC_FRAME_ADC_CLK_HZ / (ADC_FRAME_CONV_CYCLES * ADC_FRAME_CH_NUM))
+
+/**
+ * VDDA 补偿：
+ * 每帧采一次 Vrefint，滤波后得到 VDDA = Vrefint_mv * 4096 / vrefint。
+ * Vrefint 逐片有 ±3% 的离散且 F103 没有出厂校准值，用典型值会给所有电流通道带来同量级的增益误差，
+ * 所以 Vrefint_mv 按板标定（adc_frame_calibrate_vrefint，存入 nv_config），未标定时用 ADC_VREFINT_MV。
+ * 电流类通道（电机/热控/风扇）的码值按 VDDA / ADC_VREF_MV 缩放到标称参考下，
+ * 因此所有消费者拿到的码值与供电跌落无关，阈值按标称 3.3V 计算即可。
+ * NTC 分压与 ADC 同源时为比例式测量，原样传递（见 NTC_DIVIDER_RATIOMETRIC）。
+ */
+#define ADC_FRAME_VREF_FILT_SHIFT   4U      // Vrefint IIR 系数 1/16（约 4ms）
+#define ADC_FRAME_VREFINT_RAW_MIN(mv)   (((mv) * ADC_RESOLUTION) / 3600U)   // VDDA=3.6V
+#define ADC_FRAME_VREFINT_RAW_MAX(mv)   (((mv) * ADC_RESOLUTION) / 2400U)   // VDDA=2.4V
+#define ADC_FRAME_VDDA_CAL_MIN_MV   2400U   // 标定时允许输入的 VDDA 范围
+#define ADC_FRAME_VDDA_CAL_MAX_MV   3600U
+
+/* 最多可注册的帧回调个数 */
+#define ADC_FRAME_HOOK_MAX      8U
+
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+
+/**
+ * @brief  启动 ADC1 全通道扫描 + DMA 循环采集
+ * @note   重复调用无副作用；需在 nv_config_init 之后调用（读取 Vrefint 标定值）
+ * @retval None
+ */
+void adc_frame_init(void);
+
+/**
+ * @brief  注册帧回调，每完成一帧调用一次
+ * @param  hook: 回调函数
+ * @retval 1=成功，0=回调表已满
+ */
+uint8_t adc_frame_register_hook(adc_frame_hook_t hook);
+
+/**
+ * @brief  读取指定通道最新的采样值（0~4095，电流类通道为补偿后的码值）
+ * @param  ch: 帧内通道序号
+ * @retval 码值，越界返回0
+ */
+uint16_t adc_frame_get_raw(adc_frame_ch_t ch);
+
+/**
+ * @brief  获取最近完成的一整帧
+ * @retval 指向 ADC_FRAME_CH_NUM 个原始值的指针（DMA 下一轮覆盖前有效）
+ */
+const uint16_t *adc_frame_latest(void);
+
+/**
+ * @brief  获取当前 VDDA（由 Vrefint 推算，已滤波）
+ * @retval 毫伏
+ */
+uint16_t adc_frame_get_vdda_mv(void);
+
+/**
+ * @brief  设置 Vrefint 实际电压（不写 flash）
+ * @param  mv: ADC_VREFINT_MV_MIN~ADC_VREFINT_MV_MAX，0 或越界用默认值 ADC_VREFINT_MV
+ */
+void adc_frame_set_vrefint_mv(uint16_t mv);
+
+/**
+ * @brief  获取当前使用的 Vrefint 电压
+ * @retval 毫伏
+ */
+uint16_t adc_frame_get_vrefint_mv(void);
+
+/**
+ * @brief  Vrefint 标定：用表实测 VDDA 引脚电压，由当前滤波后的 Vrefint 码值反推 Vrefint，并写入 nv_config
+ * @param  vdda_mv: 实测 VDDA（毫伏）
+ * @retval 1=成功，0=参数/结果超出范围或写入失败
+ * @note   写 flash 会挂起 CPU 数十毫秒，调用前关闭加热
+ */
+uint8_t adc_frame_calibrate_vrefint(uint16_t vdda_mv);
+
+/**
+ * @brief  把补偿后的码值换算成毫伏（按标称参考 ADC_VREF_MV）
+ * @param  code: adc_frame_get_raw 或帧回调里的码值
+ * @retval 毫伏
+ */
+uint16_t adc_frame_code_to_mv(uint16_t code);
+
+/**
+ * @brief  获取已完成的帧计数（每帧加1）
+ * @retval 帧序号
+ */
+uint32_t adc_frame_get_seq(void);
+
+/**
+ * @brief  DMA1 通道1 中断处理，在 DMA1_Channel1_IRQHandler 中调用
+ * @retval None
+ */
+void adc_frame_dma_irq_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ADC_FRAME_H__ */
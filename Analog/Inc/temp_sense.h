@@ -0,0 +1,120 @@
+#ifndef __TEMP_SENSE_H__
+#define __TEMP_SENSE_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *                              类型定义
+ ******************************************************************************/
+
+/**
+ * @brief 温度通道
+ */
+typedef enum
+{
+    TEMP_SENSE_NTC1 = 0,        ///< ADC CH8  PB0
+    TEMP_SENSE_NTC2,            ///< ADC CH9  PB1
+    TEMP_SENSE_CH_NUM
+} temp_sense_ch_t;
+
+/**
+ * @brief 通道状态
+ * @note  只有 TEMP_SENSE_OK 时 temp/rate 有意义；故障需连续 TEMP_SENSE_FAULT_CONFIRM
+ *        个采样才确认，恢复同样需要连续确认，恢复后滤波器从当前值重新开始。
+ *        连续 TEMP_SENSE_DROP_MAX 个抽取窗口因跳变被丢弃时置 TEMP_SENSE_STALE；
+ *        temp_sense_read 读到超过 TEMP_SENSE_MAX_AGE_MS 的 OK 快照（ADC 帧流停了）也报 TEMP_SENSE_STALE。
+ */
+typedef enum
+{
+    TEMP_SENSE_INIT = 0,        ///< 尚未得到第一个采样
+    TEMP_SENSE_OK,
+    TEMP_SENSE_SHORT,           ///< NTC短路（采样贴近短路端）
+    TEMP_SENSE_OPEN,            ///< NTC断路/未接
+    TEMP_SENSE_STALE            ///< 持续跳变或采样停止，温度不再更新
+} temp_sense_status_t;
+
+/**
+ * @brief 一次读数快照
+ */
+typedef struct
+{
+    int32_t  temp_centi;        ///< 滤波后温度（0.01℃）
+    int32_t  rate_centi_s;      ///< 温升速率（0.01℃/s），按 TEMP_SENSE_RATE_WINDOW 个采样计算
+    uint16_t raw;               ///< 本次采样的ADC平均值
+    uint8_t  status;            ///< temp_sense_status_t
+    uint8_t  reserved;
+    uint32_t tick_ms;           ///< 采样时刻（HAL_GetTick）
+    uint32_t seq;               ///< 采样序号，每个新采样加1，可用来判断数据是否更新
+} temp_sense_reading_t;
+
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+
+/* 每 TEMP_SENSE_DECIM 帧取一次平均作为一个采样（3663/32 ≈ 114Hz） */
+#define TEMP_SENSE_DECIM            32U
+/* IIR 默认系数：y += (x - y) >> shift，3 ≈ 8个采样（约70ms）时间常数 */
+#define TEMP_SENSE_IIR_SHIFT_DEFAULT 3U
+#define TEMP_SENSE_IIR_SHIFT_MAX    8U
+/* 温升速率窗口（采样数，约 0.56s） */
+#define TEMP_SENSE_RATE_WINDOW      64U
+/* 抽取窗口内最大最小值之差超过此值（ADC码）视为跳变，丢弃该窗口 */
+#define TEMP_SENSE_SPREAD_MAX       256U
+/* 故障/恢复确认采样数 */
+#define TEMP_SENSE_FAULT_CONFIRM    3U
+/* 连续丢弃多少个抽取窗口判为 STALE（8 个约 70ms） */
+#define TEMP_SENSE_DROP_MAX         8U
+/* 快照最大年龄，超过视为 STALE（约 11 个采样周期） */
+#define TEMP_SENSE_MAX_AGE_MS       100U
+
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+
+/**
+ * @brief  初始化温度服务并挂到 ADC 帧流上
+ * @note   会调用 adc_frame_init；NTC 标定系数由 thermistor_sh_init 预先加载
+ * @retval None
+ */
+void temp_sense_init(void);
+
+/**
+ * @brief  设置某通道的 IIR 滤波系数
+ * @param  ch: 通道
+ * @param  shift: 0=不滤波，越大越平滑，上限 TEMP_SENSE_IIR_SHIFT_MAX
+ * @retval None
+ */
+void temp_sense_set_filter(temp_sense_ch_t ch, uint8_t shift);
+
+/**
+ * @brief  读取一致的快照（无锁，可在任务或低于 ADC DMA 中断优先级的中断里调用）
+ * @param  ch: 通道
+ * @param  out: 输出快照
+ * @retval 1=状态为 TEMP_SENSE_OK，0=未就绪/故障/过期/参数错误
+ * @note   快照超过 TEMP_SENSE_MAX_AGE_MS 时 out->status 改为 TEMP_SENSE_STALE
+ */
+uint8_t temp_sense_read(temp_sense_ch_t ch, temp_sense_reading_t *out);
+
+/**
+ * @brief  读取通道状态（含过期判断，同 temp_sense_read）
+ * @retval temp_sense_status_t
+ */
+temp_sense_status_t temp_sense_get_status(temp_sense_ch_t ch);
+
+/**
+ * @brief  发布快照数组的只读视图（TEMP_SENSE_CH_NUM 个，供寄存器映射零拷贝读取）
+ * @note   不经过序号锁：单个对齐的 32 位字段读取是原子的，但同一通道的多个字段
+ *         可能来自相邻两次采样；需要一致快照时用 temp_sense_read
+ * @retval 快照数组首地址
+ */
+const temp_sense_reading_t *temp_sense_live(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TEMP_SENSE_H__ */
@@ -0,0 +1,350 @@
+#include "adc_frame.h"
+#include "adc.h"
+#include "nv_config.h"
+
+/******************************************************************************
+ *                              私有变量定义
+ ******************************************************************************/
+
+/**
+ * @brief 每一帧内各 Rank 对应的 ADC 通道
+ * @note  顺序必须与 adc_frame_ch_t 一致
+ */
+static const uint32_t s_frame_channel[ADC_FRAME_CH_NUM] =
+{
+    MOTOR1_CURRENT_ADC_CHANNEL,
+    MOTOR2_CURRENT_ADC_CHANNEL,
+    MOTOR3_CURRENT_ADC_CHANNEL,
+    MOTOR4_CURRENT_ADC_CHANNEL,
+    MOTOR5_CURRENT_ADC_CHANNEL,
+    MOTOR6_CURRENT_ADC_CHANNEL,
+    NTC1_ADC_CHANNEL,
+    NTC2_ADC_CHANNEL,
+    HEAT_CURRENT1_ADC_CHANNEL,
+    HEAT_CURRENT2_ADC_CHANNEL,
+    FAN1_CURRENT_ADC_CHANNEL,
+    FAN2_CURRENT_ADC_CHANNEL,
+    ADC_VREFINT_CHANNEL,
+};
+
+/**
+ * @brief 各通道是否按 VDDA 补偿
+ * @note  电流采样是对固定电压的绝对测量，需要补偿；比例式的 NTC 分压和 Vrefint 本身不补偿
+ */
+static const uint8_t s_frame_comp[ADC_FRAME_CH_NUM] =
+{
+    1, 1, 1, 1, 1, 1,
+    !NTC_DIVIDER_RATIOMETRIC,
+    !NTC_DIVIDER_RATIOMETRIC,
+    1, 1,
+    1, 1,
+    0,
+};
+
+/**
+ * @brief DMA 双帧缓冲
+ * @note  DMA 循环模式写满两帧：半传输中断时第0帧完整，传输完成中断时第1帧完整，
+ *        处理一帧的同时 DMA 正在写另一帧，互不干扰。
+ */
+static uint16_t s_frame_buf[2][ADC_FRAME_CH_NUM];
+
+/* 补偿后的帧，与 DMA 半区一一对应，生命周期相同 */
+static uint16_t s_comp_buf[2][ADC_FRAME_CH_NUM];
+
+static DMA_HandleTypeDef s_hdma_adc1;
+
+static adc_frame_hook_t s_hooks[ADC_FRAME_HOOK_MAX];
+static uint8_t s_hook_num = 0;
+
+static const uint16_t *volatile s_latest = s_comp_buf[0];
+static volatile uint32_t s_frame_seq = 0;
+
+/* Vrefint 滤波值（Q4），0 表示还没有采样 */
+static uint32_t s_vref_q4 = 0;
+/* 补偿系数（Q15）= VDDA / ADC_VREF_MV */
+static uint32_t s_comp_q15 = 1UL << 15;
+static volatile uint16_t s_vdda_mv = ADC_VREF_MV;
+
+/* 由 Vrefint 电压导出的常数，见 adc_frame_set_vrefint_mv */
+static uint16_t s_vrefint_mv = ADC_VREFINT_MV;
+static uint32_t s_k_comp = (uint32_t)((uint64_t)ADC_VREFINT_MV * ADC_RESOLUTION * (1UL << 19) / ADC_VREF_MV);
+static uint32_t s_k_vdda = ADC_VREFINT_MV * ADC_RESOLUTION * 16U;
+static uint16_t s_vref_raw_min = ADC_FRAME_VREFINT_RAW_MIN(ADC_VREFINT_MV);
+static uint16_t s_vref_raw_max = ADC_FRAME_VREFINT_RAW_MAX(ADC_VREFINT_MV);
+static uint8_t s_started = 0;
+
+/******************************************************************************
+ *                              内部工具函数
+ ******************************************************************************/
+
+/**
+ * @brief 把帧内用到的引脚全部配置为模拟输入
+ * @note  CubeMX 生成的 HAL_ADC_MspInit 只配置了 PA0
+ */
+static void adc_frame_gpio_init(void)
+{
+    GPIO_InitTypeDef gpio = {0};
+
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+
+    gpio.Mode = GPIO_MODE_ANALOG;
+
+    gpio.Pin = GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3 | GPIO_PIN_4 | GPIO_PIN_5;
+    HAL_GPIO_Init(GPIOA, &gpio);
+
+    gpio.Pin = NTC1_ADC_PIN | NTC2_ADC_PIN;
+    HAL_GPIO_Init(NTC1_ADC_PORT, &gpio);
+
+    // PC0/PC1 热控电流，PC2/PC3 风扇电流（Vrefint 是内部通道，无引脚）
+    gpio.Pin = HEAT_CURRENT1_ADC_PIN | HEAT_CURRENT2_ADC_PIN | GPIO_PIN_2 | GPIO_PIN_3;
+    HAL_GPIO_Init(GPIOC, &gpio);
+}
+
+/**
+ * @brief 配置 DMA1 通道1：ADC1->DR 到 s_frame_buf，半字、循环模式
+ */
+static void adc_frame_dma_init(void)
+{
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    s_hdma_adc1.Instance = DMA1_Channel1;
+    s_hdma_adc1.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    s_hdma_adc1.Init.PeriphInc = DMA_PINC_DISABLE;
+    s_hdma_adc1.Init.MemInc = DMA_MINC_ENABLE;
+    s_hdma_adc1.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    s_hdma_adc1.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+    s_hdma_adc1.Init.Mode = DMA_CIRCULAR;
+    s_hdma_adc1.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&s_hdma_adc1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+    __HAL_LINKDMA(&hadc1, DMA_Handle, s_hdma_adc1);
+
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+}
+
+/**
+ * @brief 把 ADC1 从 CubeMX 的单通道配置改为全通道连续扫描
+ */
+static void adc_frame_adc_init(void)
+{
+    ADC_ChannelConfTypeDef conf = {0};
+
+    hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;
+    hadc1.Init.ContinuousConvMode = ENABLE;
+    hadc1.Init.DiscontinuousConvMode = DISABLE;
+    hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+    hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+    hadc1.Init.NbrOfConversion = ADC_FRAME_CH_NUM;
+    if (HAL_ADC_Init(&hadc1) != HAL_OK)
+    {
+        Error_Handler();
+    }
+
+    // 长采样时间：NTC 分压源阻抗较高，Vrefint 要求 ≥17.1us（此处 20us），帧率约 3.7kHz
+    // ConfigChannel 配置 CH17 时会自动置位 TSVREFE
+    conf.SamplingTime = ADC_SAMPLETIME_239CYCLES_5;
+    for (uint32_t i = 0; i < ADC_FRAME_CH_NUM; i++)
+    {
+        conf.Channel = s_frame_channel[i];
+        conf.Rank = ADC_REGULAR_RANK_1 + i;
+        if (HAL_ADC_ConfigChannel(&hadc1, &conf) != HAL_OK)
+        {
+            Error_Handler();
+        }
+    }
+
+    HAL_ADCEx_Calibration_Start(&hadc1);
+}
+
+/**
+ * @brief 用本帧的 Vrefint 更新 VDDA 和补偿系数
+ * @note  K = Vrefint_mv * 4096 * 2^19 / ADC_VREF_MV，comp_q15 = K / vref_q4，
+ *        每帧一次 32 位除法
+ */
+static void adc_frame_update_vref(uint16_t vref_raw)
+{
+    // 超出 VDDA 2.4~3.6V 对应的范围说明采样异常，钳位，不让补偿跑飞
+    if (vref_raw < s_vref_raw_min) vref_raw = s_vref_raw_min;
+    if (vref_raw > s_vref_raw_max) vref_raw = s_vref_raw_max;
+
+    if (s_vref_q4 == 0)
+    {
+        s_vref_q4 = (uint32_t)vref_raw << ADC_FRAME_VREF_FILT_SHIFT;
+    }
+    else
+    {
+        s_vref_q4 += vref_raw - (s_vref_q4 >> ADC_FRAME_VREF_FILT_SHIFT);
+    }
+
+    s_comp_q15 = s_k_comp / s_vref_q4;
+    s_vdda_mv = (uint16_t)(s_k_vdda / s_vref_q4);
+}
+
+/**
+ * @brief 一帧完成：补偿、更新最新帧指针并依次调用所有回调
+ */
+static void adc_frame_dispatch(uint8_t half)
+{
+    const uint16_t *raw = s_frame_buf[half];
+    uint16_t *frame = s_comp_buf[half];
+
+    adc_frame_update_vref(raw[ADC_FRAME_VREFINT]);
+
+    for (uint8_t i = 0; i < ADC_FRAME_CH_NUM; i++)
+    {
+        uint32_t v = raw[i];
+        if (s_frame_comp[i])
+        {
+            v = (v * s_comp_q15 + (1UL << 14)) >> 15;
+            if (v > ADC_RESOLUTION - 1U) v = ADC_RESOLUTION - 1U;
+        }
+        frame[i] = (uint16_t)v;
+    }
+
+    s_latest = frame;
+    s_frame_seq++;
+
+    for (uint8_t i = 0; i < s_hook_num; i++)
+    {
+        s_hooks[i](frame);
+    }
+}
+
+/******************************************************************************
+ *                              对外接口
+ ******************************************************************************/
+
+void adc_frame_init(void)
+{
+    if (s_started)
+    {
+        return;
+    }
+
+    adc_frame_set_vrefint_mv(nv_config_get()->vrefint_mv);
+    adc_frame_gpio_init();
+    adc_frame_dma_init();
+    adc_frame_adc_init();
+
+    HAL_ADC_Start_DMA(&hadc1, (uint32_t *)s_frame_buf, 2U * ADC_FRAME_CH_NUM);
+    s_started = 1;
+}
+
+uint8_t adc_frame_register_hook(adc_frame_hook_t hook)
+{
+    if (hook == NULL || s_hook_num >= ADC_FRAME_HOOK_MAX)
+    {
+        return 0;
+    }
+
+    for (uint8_t i = 0; i < s_hook_num; i++)
+    {
+        if (s_hooks[i] == hook)
+        {
+            return 1;   // 已注册
+        }
+    }
+
+    s_hooks[s_hook_num++] = hook;
+    return 1;
+}
+
+uint16_t adc_frame_get_raw(adc_frame_ch_t ch)
+{
+    if (ch >= ADC_FRAME_CH_NUM) return 0;
+    return s_latest[ch];
+}
+
+const uint16_t *adc_frame_latest(void)
+{
+    return s_latest;
+}
+
+uint16_t adc_frame_get_vdda_mv(void)
+{
+    return s_vdda_mv;
+}
+
+void adc_frame_set_vrefint_mv(uint16_t mv)
+{
+    if (mv < ADC_VREFINT_MV_MIN || mv > ADC_VREFINT_MV_MAX) mv = ADC_VREFINT_MV;
+
+    // 帧中断里成组使用这些常数，一起更新
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s_vrefint_mv = mv;
+    s_k_comp = (uint32_t)((uint64_t)mv * ADC_RESOLUTION * (1UL << 19) / ADC_VREF_MV);
+    s_k_vdda = (uint32_t)mv * ADC_RESOLUTION * 16U;
+    s_vref_raw_min = (uint16_t)ADC_FRAME_VREFINT_RAW_MIN((uint32_t)mv);
+    s_vref_raw_max = (uint16_t)ADC_FRAME_VREFINT_RAW_MAX((uint32_t)mv);
+    __set_PRIMASK(primask);
+}
+
+uint16_t adc_frame_get_vrefint_mv(void)
+{
+    return s_vrefint_mv;
+}
+
+uint8_t adc_frame_calibrate_vrefint(uint16_t vdda_mv)
+{
+    uint32_t vref_q4 = s_vref_q4;
+    uint32_t mv;
+
+    if (vdda_mv < ADC_FRAME_VDDA_CAL_MIN_MV || vdda_mv > ADC_FRAME_VDDA_CAL_MAX_MV || vref_q4 == 0) return 0;
+
+    // Vrefint = VDDA * vrefint_code / 4096，vref_q4 为 Q4 滤波值
+    mv = ((uint32_t)vdda_mv * vref_q4 + ADC_RESOLUTION * 8U) / (ADC_RESOLUTION * 16U);
+    if (mv < ADC_VREFINT_MV_MIN || mv > ADC_VREFINT_MV_MAX) return 0;
+
+    adc_frame_set_vrefint_mv((uint16_t)mv);
+
+    nv_config_t cfg = *nv_config_get();
+    cfg.vrefint_mv = (uint16_t)mv;
+    return nv_config_save(&cfg);
+}
+
+uint16_t adc_frame_code_to_mv(uint16_t code)
+{
+    return (uint16_t)(((uint32_t)code * ADC_VREF_MV) / ADC_RESOLUTION);
+}
+
+uint32_t adc_frame_get_seq(void)
+{
+    return s_frame_seq;
+}
+
+void adc_frame_dma_irq_handler(void)
+{
+    HAL_DMA_IRQHandler(&s_hdma_adc1);
+}
+
+/******************************************************************************
+ *                            中断回调函数
+ ******************************************************************************/
+
+/**
+ * @brief  DMA 半传输完成：第0帧可用
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1)
+    {
+        adc_frame_dispatch(0);
+    }
+}
+
+/**
+ * @brief  DMA 传输完成：第1帧可用
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
+{
+    if (hadc->Instance == ADC1)
+    {
+        adc_frame_dispatch(1);
+    }
+}
@@ -0,0 +1,289 @@
+#include "temp_sense.h"
+#include "adc_frame.h"
+#include "thermistor_steinhart_hart.h"
+
+/******************************************************************************
+ *                              私有类型定义
+ ******************************************************************************/
+
+/**
+ * @brief 通道内部状态，只在 ADC DMA 中断里修改
+ */
+typedef struct
+{
+    uint32_t raw_sum;                           ///< 当前抽取窗口的采样累加
+    uint16_t raw_min;                           ///< 当前抽取窗口的最小/最大值
+    uint16_t raw_max;
+    int32_t  filt_q8;                           ///< IIR 状态（0.01℃，Q8）
+    int32_t  hist[TEMP_SENSE_RATE_WINDOW];      ///< 最近若干采样的滤波温度，用于算速率
+    uint8_t  hist_idx;
+    uint8_t  hist_full;
+    uint8_t  shift;
+    uint8_t  status;
+    uint8_t  bad_cnt;
+    uint8_t  good_cnt;
+    uint8_t  bad_status;                        ///< 正在确认中的故障类型
+    uint8_t  drop_cnt;                          ///< 连续被丢弃的抽取窗口数
+    uint32_t sample_seq;
+} temp_sense_state_t;
+
+/******************************************************************************
+ *                              私有变量定义
+ ******************************************************************************/
+
+static const adc_frame_ch_t s_adc_ch[TEMP_SENSE_CH_NUM] =
+{
+    ADC_FRAME_NTC1,
+    ADC_FRAME_NTC2,
+};
+
+static temp_sense_state_t s_state[TEMP_SENSE_CH_NUM];
+
+/**
+ * @brief 对外发布的快照，用序号锁保护
+ * @note  写者只有 ADC DMA 中断：写之前 s_lock 变奇数，写完变偶数。
+ *        读者拷贝前后序号一致且为偶数才算有效，否则重读。
+ *        写者优先级高于读者，读者最多重试一次就能成功。
+ */
+static temp_sense_reading_t s_pub[TEMP_SENSE_CH_NUM];
+static volatile uint32_t s_lock[TEMP_SENSE_CH_NUM];
+
+static uint8_t s_frame_cnt = 0;
+static uint8_t s_inited = 0;
+
+/******************************************************************************
+ *                              内部工具函数
+ ******************************************************************************/
+
+/**
+ * @brief 状态机：连续确认故障/恢复
+ * @retval 1=本采样可用于更新温度
+ */
+static uint8_t temp_sense_update_status(temp_sense_state_t *s, int32_t t)
+{
+    if (t == THERMISTOR_CENTI_SHORT || t == THERMISTOR_CENTI_OPEN)
+    {
+        uint8_t fault = (t == THERMISTOR_CENTI_SHORT) ? TEMP_SENSE_SHORT : TEMP_SENSE_OPEN;
+
+        if (s->bad_status != fault)
+        {
+            s->bad_status = fault;
+            s->bad_cnt = 0;
+        }
+        s->good_cnt = 0;
+        if (s->bad_cnt < TEMP_SENSE_FAULT_CONFIRM && ++s->bad_cnt >= TEMP_SENSE_FAULT_CONFIRM)
+        {
+            s->status = fault;
+        }
+        return 0;
+    }
+
+    s->bad_cnt = 0;
+    s->bad_status = TEMP_SENSE_OK;
+    if (s->status == TEMP_SENSE_OK)
+    {
+        return 1;
+    }
+
+    // 上电第一个好采样直接可用，故障恢复需要连续确认
+    if (s->status == TEMP_SENSE_INIT || ++s->good_cnt >= TEMP_SENSE_FAULT_CONFIRM)
+    {
+        s->status = TEMP_SENSE_OK;
+        s->good_cnt = 0;
+        s->filt_q8 = t * 256;
+        s->hist_idx = 0;
+        s->hist_full = 0;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief 处理一个抽取后的采样
+ */
+static void temp_sense_sample(temp_sense_ch_t ch, uint16_t raw, uint32_t tick)
+{
+    temp_sense_state_t *s = &s_state[ch];
+    temp_sense_reading_t *p = &s_pub[ch];
+    int32_t t = thermistor_sh_centi_celsius((uint8_t)ch, raw);
+    uint8_t use = temp_sense_update_status(s, t);
+    int32_t rate = p->rate_centi_s;
+
+    if (use)
+    {
+        s->filt_q8 += (t * 256 - s->filt_q8) >> s->shift;
+        t = s->filt_q8 / 256;
+
+        // hist[hist_idx] 是 TEMP_SENSE_RATE_WINDOW 个采样之前的值
+        if (s->hist_full)
+        {
+            rate = (t - s->hist[s->hist_idx]) * (int32_t)ADC_FRAME_RATE_HZ
+                 / (int32_t)(TEMP_SENSE_DECIM * TEMP_SENSE_RATE_WINDOW);
+        }
+        else
+        {
+            rate = 0;
+        }
+        s->hist[s->hist_idx] = t;
+        if (++s->hist_idx >= TEMP_SENSE_RATE_WINDOW)
+        {
+            s->hist_idx = 0;
+            s->hist_full = 1;
+        }
+    }
+    s->sample_seq++;
+
+    s_lock[ch]++;
+    __DMB();
+    if (use)
+    {
+        p->temp_centi = t;
+        p->rate_centi_s = rate;
+    }
+    p->raw = raw;
+    p->status = s->status;
+    p->tick_ms = tick;
+    p->seq = s->sample_seq;
+    __DMB();
+    s_lock[ch]++;
+}
+
+/**
+ * @brief 抽取窗口因跳变被丢弃：连续 TEMP_SENSE_DROP_MAX 个后置 STALE 并发布，
+ *        之后的好采样按故障恢复处理（连续确认、滤波器重新开始）
+ */
+static void temp_sense_drop(temp_sense_ch_t ch)
+{
+    temp_sense_state_t *s = &s_state[ch];
+
+    if (s->drop_cnt < TEMP_SENSE_DROP_MAX && ++s->drop_cnt >= TEMP_SENSE_DROP_MAX)
+    {
+        s->status = TEMP_SENSE_STALE;
+        s->good_cnt = 0;
+
+        s_lock[ch]++;
+        __DMB();
+        s_pub[ch].status = s->status;
+        __DMB();
+        s_lock[ch]++;
+    }
+}
+
+/**
+ * @brief 快照是否过期（ADC 帧流停止时不会再有新采样）
+ */
+static uint8_t temp_sense_is_old(const temp_sense_reading_t *r)
+{
+    return r->status == TEMP_SENSE_OK && HAL_GetTick() - r->tick_ms > TEMP_SENSE_MAX_AGE_MS;
+}
+
+/**
+ * @brief 帧回调：累加 NTC 采样，每 TEMP_SENSE_DECIM 帧出一个平均值
+ */
+static void temp_sense_on_adc_frame(const uint16_t *frame)
+{
+    for (uint8_t i = 0; i < TEMP_SENSE_CH_NUM; i++)
+    {
+        uint16_t v = frame[s_adc_ch[i]];
+        temp_sense_state_t *s = &s_state[i];
+
+        s->raw_sum += v;
+        if (v < s->raw_min) s->raw_min = v;
+        if (v > s->raw_max) s->raw_max = v;
+    }
+
+    if (++s_frame_cnt < TEMP_SENSE_DECIM)
+    {
+        return;
+    }
+    s_frame_cnt = 0;
+
+    uint32_t tick = HAL_GetTick();
+    for (uint8_t i = 0; i < TEMP_SENSE_CH_NUM; i++)
+    {
+        temp_sense_state_t *s = &s_state[i];
+        uint16_t raw = (uint16_t)((s->raw_sum + TEMP_SENSE_DECIM / 2U) / TEMP_SENSE_DECIM);
+        uint16_t spread = s->raw_max - s->raw_min;
+
+        s->raw_sum = 0;
+        s->raw_min = 0xFFFFU;
+        s->raw_max = 0;
+
+        // 窗口内跳变（插拔、断线瞬间）的平均值是两种状态的混合，可能落在正常温度范围内，丢弃
+        if (spread <= TEMP_SENSE_SPREAD_MAX)
+        {
+            s->drop_cnt = 0;
+            temp_sense_sample((temp_sense_ch_t)i, raw, tick);
+        }
+        else
+        {
+            temp_sense_drop((temp_sense_ch_t)i);
+        }
+    }
+}
+
+/******************************************************************************
+ *                              对外接口
+ ******************************************************************************/
+
+void temp_sense_init(void)
+{
+    if (s_inited)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < TEMP_SENSE_CH_NUM; i++)
+    {
+        s_state[i] = (temp_sense_state_t){0};
+        s_state[i].shift = TEMP_SENSE_IIR_SHIFT_DEFAULT;
+        s_state[i].status = TEMP_SENSE_INIT;
+        s_state[i].raw_min = 0xFFFFU;
+        s_pub[i] = (temp_sense_reading_t){0};
+        s_lock[i] = 0;
+    }
+    s_frame_cnt = 0;
+
+    adc_frame_init();
+    adc_frame_register_hook(temp_sense_on_adc_frame);
+    s_inited = 1;
+}
+
+void temp_sense_set_filter(temp_sense_ch_t ch, uint8_t shift)
+{
+    if (ch >= TEMP_SENSE_CH_NUM) return;
+    if (shift > TEMP_SENSE_IIR_SHIFT_MAX) shift = TEMP_SENSE_IIR_SHIFT_MAX;
+    s_state[ch].shift = shift;      // 单字节写，下个采样生效
+}
+
+uint8_t temp_sense_read(temp_sense_ch_t ch, temp_sense_reading_t *out)
+{
+    uint32_t seq;
+
+    if (ch >= TEMP_SENSE_CH_NUM || out == NULL) return 0;
+
+    do
+    {
+        seq = s_lock[ch];
+        __DMB();
+        *out = s_pub[ch];
+        __DMB();
+    } while ((seq & 1U) || seq != s_lock[ch]);
+
+    if (temp_sense_is_old(out)) out->status = TEMP_SENSE_STALE;
+    return out->status == TEMP_SENSE_OK;
+}
+
+temp_sense_status_t temp_sense_get_status(temp_sense_ch_t ch)
+{
+    temp_sense_reading_t r;
+
+    if (ch >= TEMP_SENSE_CH_NUM) return TEMP_SENSE_INIT;
+    (void)temp_sense_read(ch, &r);
+    return (temp_sense_status_t)r.status;
+}
+
+const temp_sense_reading_t *temp_sense_live(void)
+{
+    return s_pub;
+}
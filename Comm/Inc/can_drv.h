@@ -0,0 +1,60 @@
+#ifndef CAN_DRV_H
+#define CAN_DRV_H
+
+#include "stm32f103xe.h"
+#include "hardware_config.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief bxCAN 驱动（CAN1，remap 到 PB8=RX / PB9=TX，仅标准帧）
+ * 接收：只有命中硬件过滤器的帧才进 FIFO，无关报文 CPU 完全看不到；
+ *       FIFO0/FIFO1 各有独立中断，可把紧急命令分到另一个 FIFO，不被普通请求堵住。
+ * 发送：三个发送邮箱都用上，硬件按 ID 仲裁（TXFP=0）；邮箱满时进按 ID 排序的软件队列，
+ *       邮箱空出（TME 中断）立即补位。若新帧优先级高于邮箱里最低的一帧，
+ *       中止那一帧让位，被中止的帧回到队列，避免优先级反转。
+ *       同 ID 的帧不保证先后顺序（硬件在 ID 相同时按邮箱号发送）。
+ *
+ * CAN HAL 模块未启用，直接操作寄存器。
+ */
+#define CAN_CLK_HZ              (SYSTEM_CLOCK_FREQ / 2U)    // APB1 36MHz
+#define CAN_TQ_PER_BIT          18U
+#define CAN_BS1_TQ              15U         // 采样点 (1+15)/18 = 88.9%
+#define CAN_BS2_TQ              2U
+#define CAN_SJW_TQ              1U
+#define CAN_FILTER_BANK_NUM     14U
+#define CAN_TX_QUEUE_LEN        16U
+#define CAN_IRQ_PRIORITY        2U          // 与 RS485 相同，低于 ADC DMA
+
+typedef struct{
+    uint16_t id;            // 11 位标准 ID
+    uint8_t  dlc;           // 0~8
+    uint8_t  data[8];
+}can_frame_t;
+
+/**
+ * @brief 接收回调（在对应 FIFO 的中断里调用）
+ * @param fifo 0/1
+ */
+typedef void (*can_rx_cb_t)(uint8_t fifo, const can_frame_t *frame);
+
+typedef struct{
+    uint32_t tx_dropped;    // 队列满丢弃
+    uint32_t tx_preempted;  // 为高优先级帧让出邮箱的次数
+    uint32_t rx_overrun;    // FIFO 溢出次数
+}can_drv_stats_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+#ifdef USE_CAN_COMM
+uint8_t can_drv_init(uint32_t bitrate, can_rx_cb_t cb);
+uint8_t can_drv_set_filter(uint8_t bank, uint16_t id, uint16_t mask, uint8_t fifo);
+uint8_t can_drv_send(const can_frame_t *frame);
+void can_drv_get_stats(can_drv_stats_t *stats);
+uint32_t can_drv_get_esr(void);
+void can_drv_tx_irq_handler(void);
+void can_drv_rx0_irq_handler(void);
+void can_drv_rx1_irq_handler(void);
+#endif
+
+#endif // CAN_DRV_H
@@ -0,0 +1,37 @@
+#ifndef CAN_PROTO_H
+#define CAN_PROTO_H
+
+#include "can_drv.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief CAN 寄存器访问协议（与 Modbus 共用 reg_map，寄存器地址/含义相同）
+ * 请求  ID = CAN_PROTO_REQ_BASE + 节点号，过滤器 0 精确匹配 → FIFO0
+ * 应答  ID = CAN_PROTO_RSP_BASE + 节点号
+ * 广播  ID = CAN_PROTO_BCAST_ID（最高优先级），过滤器 1 → FIFO1，只执行写、不应答，
+ *       单独占一个 FIFO，急停等广播命令不会排在普通请求后面。
+ *
+ * 请求：[0]=功能码 [1..2]=起始地址(大端) [3]=寄存器数 [4..]=写入数据(大端)
+ *   0x03/0x04 读保持/输入寄存器，1~3 个
+ *   0x10      写保持寄存器，1~2 个
+ * 应答：读  [0]=功能码 [1]=寄存器数 [2..]=数据
+ *       写  [0]=功能码 [1..2]=起始地址 [3]=寄存器数
+ *       异常 [0]=功能码|0x80 [1]=异常码（同 Modbus）
+ * 单帧一问一答，没有 Modbus 的 3.5 字符间隔和半双工换向，多个节点可同时应答。
+ */
+#define CAN_PROTO_REQ_BASE      0x600U
+#define CAN_PROTO_RSP_BASE      0x580U
+#define CAN_PROTO_BCAST_ID      0x000U
+#define CAN_PROTO_NODE_MAX      127U
+#define CAN_PROTO_READ_MAX      3U
+#define CAN_PROTO_WRITE_MAX     2U
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+#ifdef USE_CAN_COMM
+uint8_t can_proto_init(uint8_t node_id, uint32_t bitrate);
+uint8_t can_proto_get_node_id(void);
+#endif
+
+#endif // CAN_PROTO_H
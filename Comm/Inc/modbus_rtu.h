@@ -0,0 +1,66 @@
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+#include <stdint.h>
+#include "hardware_config.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief Modbus RTU 从站（RS485，见 rs485_uart.h）
+ * 支持功能码 03（读保持寄存器）、04（读输入寄存器）、06（写单个寄存器）、16（写多个寄存器）。
+ * 请求在 USART1 中断里处理完并立即启动 DMA 应答，应答时延 ≈ 1 个字符（IDLE）+ 处理时间。
+ * 广播地址 0 只执行写操作，不应答。
+ *
+ * 寄存器数据以大端字节流的形式交给 modbus_rtu_regs_t 的回调：
+ * 读回调直接把数据写进应答缓冲，写回调直接从请求帧里取，协议层不做中间拷贝。
+ *
+ * 帧结束用 IDLE（1 个字符静默）判定，比规范的 3.5 字符更早，主站连续发送的两帧之间
+ * 须留出至少 1 个字符的间隔（常规主站都满足）。
+ */
+#define MODBUS_ADDR_DEFAULT     1U
+#define MODBUS_ADU_MAX          256U
+#define MODBUS_READ_MAX         125U    // FC03/04 单次最多寄存器数
+#define MODBUS_WRITE_MAX        123U    // FC16 单次最多寄存器数
+
+typedef enum{
+    MODBUS_REG_HOLDING = 0,     // 保持寄存器（可读写）
+    MODBUS_REG_INPUT            // 输入寄存器（只读）
+}modbus_reg_type_t;
+
+typedef enum{
+    MODBUS_EX_NONE = 0,
+    MODBUS_EX_ILLEGAL_FUNCTION = 1,
+    MODBUS_EX_ILLEGAL_ADDRESS = 2,
+    MODBUS_EX_ILLEGAL_VALUE = 3,
+    MODBUS_EX_DEVICE_FAILURE = 4
+}modbus_ex_t;
+
+/**
+ * @brief 寄存器访问回调（在 USART1 中断里调用，须短小）
+ * read ：把 [addr, addr+num) 按大端写入 out（2*num 字节）
+ * write：把 in（大端，2*num 字节）写入 [addr, addr+num) 的保持寄存器
+ */
+typedef struct{
+    modbus_ex_t (*read)(modbus_reg_type_t type, uint16_t addr, uint16_t num, uint8_t *out);
+    modbus_ex_t (*write)(uint16_t addr, uint16_t num, const uint8_t *in);
+}modbus_rtu_regs_t;
+
+typedef struct{
+    uint32_t rx_frames;     // 发给本机（含广播）且 CRC 正确的帧
+    uint32_t crc_errors;
+    uint32_t exceptions;    // 返回异常应答的次数
+    uint32_t tx_busy;       // 上一应答未发完又来请求，被丢弃的次数
+}modbus_rtu_stats_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+#ifdef USE_RS485_COMM
+void modbus_rtu_init(uint8_t addr, uint32_t baud, const modbus_rtu_regs_t *regs);
+void modbus_rtu_set_addr(uint8_t addr);
+uint8_t modbus_rtu_get_addr(void);
+void modbus_rtu_get_stats(modbus_rtu_stats_t *stats);
+void modbus_rtu_on_frame(const uint8_t *frame, uint16_t len);
+#endif
+
+#endif // MODBUS_RTU_H
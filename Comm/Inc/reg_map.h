@@ -0,0 +1,51 @@
+#ifndef REG_MAP_H
+#define REG_MAP_H
+
+#include "modbus_rtu.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief Modbus 寄存器映射（声明式，直接绑定驱动内部数据）
+ * 每个块描述一段连续寄存器对应的内存数组（首地址、元素宽度、间距），读请求按块整段
+ * 拷贝进应答缓冲：16 位连续数组每次搬两个寄存器（REV16），32 位元素每次一个（REV），
+ * 不经过中间快照，也没有按寄存器号展开的 switch。新增数据只需在 reg_map.c 的表里加一行。
+ * 写请求按元素调用驱动的 set 接口，由驱动做限幅/校验。
+ *
+ * 32 位量占 2 个寄存器，高字在前；有符号量按补码传输。
+ * 一次请求可以跨相邻的块，但不能落在块之间的空洞里（返回非法地址）。
+ *
+ * 输入寄存器（04）：
+ *   0x0000~0x000C  ADC 最新一帧（adc_frame_ch_t 顺序，电流类已做 VDDA 补偿）
+ *   0x0010~0x001B  位置计数 ×6（u32，同 motor_drv_pos_get_count）
+ *   0x0020~0x0023  温度 ×2（s32，0.01℃）
+ *   0x0024~0x0027  温升速率 ×2（s32，0.01℃/s）
+ *   0x0028~0x0029  温度状态 ×2（temp_sense_status_t）
+ *   0x0030~0x0031  风扇实际占空比 ×2（‰）
+ * 保持寄存器（03/06/16）：
+ *   0x0000~0x0007  加热器占空比 ×8（‰）
+ *   0x0010~0x0015  电机方向 ×6（motor_dir_t）
+ *   0x0020~0x0021  风扇手动占空比 ×2（‰，写入即切到手动模式；读回实际输出）
+ *   0x0030         遥测时隙 ms（0=停止推送，仅 RS485 版）
+ *   0x0040~0x0059  遥测订阅 ×26（telem_sig_t 顺序，0=关/N ms/0xFFFF=变化时发，仅 RS485 版）
+ */
+#define REG_MAP_IN_ADC          0x0000U
+#define REG_MAP_IN_HALL         0x0010U
+#define REG_MAP_IN_TEMP         0x0020U
+#define REG_MAP_IN_TEMP_RATE    0x0024U
+#define REG_MAP_IN_TEMP_STATUS  0x0028U
+#define REG_MAP_IN_FAN_DUTY     0x0030U
+
+#define REG_MAP_HOLD_HEAT_DUTY  0x0000U
+#define REG_MAP_HOLD_MOTOR_DIR  0x0010U
+#define REG_MAP_HOLD_FAN_MANUAL 0x0020U
+#define REG_MAP_HOLD_TELEM_PERIOD 0x0030U
+#define REG_MAP_HOLD_TELEM_SUB  0x0040U
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+modbus_ex_t reg_map_read(modbus_reg_type_t type, uint16_t addr, uint16_t num, uint8_t *out);
+modbus_ex_t reg_map_write(uint16_t addr, uint16_t num, const uint8_t *in);
+const modbus_rtu_regs_t *reg_map_modbus_regs(void);
+
+#endif // REG_MAP_H
@@ -0,0 +1,49 @@
+#ifndef RS485_UART_H
+#define RS485_UART_H
+
+#include "stm32f103xe.h"
+#include "hardware_config.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief RS485 半双工链路（USART1：PA9=TX，PA10=RX，PA8=DE）
+ * 接收：DMA1 通道5 循环写入环形缓冲，总线空闲（IDLE，一个字符时间无数据）即一帧结束，
+ *       在 USART1 中断里把这段数据交给上层；帧不跨环尾时直接给环内指针，不拷贝。
+ * 发送：DE 拉高后 DMA1 通道4 搬运；DMA 搬完只说明最后一个字节进了发送寄存器，
+ *       再开 USART 的 TC 中断，移位寄存器真正发完才释放 DE，全程不忙等。
+ * 发送期间收发器接收被关闭，RX 上的杂波在发送结束时丢弃。
+ * 总线空闲计时：发送结束（TC）和收完一帧（IDLE）时记下 DWT 周期计数，
+ *       rs485_uart_bus_quiet 按字符时间判断空闲够不够长，分辨率不受 1ms 节拍限制。
+ *
+ * UART HAL 模块未启用，直接操作寄存器。
+ */
+#define RS485_RX_RING_SIZE      256U    // Modbus RTU 最大帧 256 字节
+#define RS485_IRQ_PRIORITY      2U      // 低于 ADC DMA（1），帧处理在此优先级完成
+#define RS485_QUIET_CLAMP_CYC   0x40000000UL    // 空闲计时封顶（约 15s），防 32 位周期计数回绕
+
+/**
+ * @brief 收到一帧的回调（在 USART1 中断里调用）
+ * @param frame 帧数据，回调返回后失效
+ */
+typedef void (*rs485_rx_cb_t)(const uint8_t *frame, uint16_t len);
+
+/**
+ * @brief 发送完成回调（USART1 中断里、DE 已释放后调用）
+ */
+typedef void (*rs485_tx_done_cb_t)(void);
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+#ifdef USE_RS485_COMM
+void rs485_uart_init(uint32_t baud, rs485_rx_cb_t cb);
+uint8_t rs485_uart_send(const uint8_t *buf, uint16_t len);
+void rs485_uart_set_tx_done_cb(rs485_tx_done_cb_t cb);
+uint8_t rs485_uart_is_busy(void);
+uint8_t rs485_uart_bus_quiet(uint16_t chars);
+uint32_t rs485_uart_get_baud(void);
+void rs485_uart_irq_handler(void);
+void rs485_uart_tx_dma_irq_handler(void);
+#endif
+
+#endif // RS485_UART_H
@@ -0,0 +1,92 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include "hardware_config.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 推送式遥测（RS485 链路，免轮询）
+ * 每 period_ms 一个发帧时隙，只把到期的订阅信号打进帧里（没有到期信号就不发），
+ * COBS 编码后以 0x00 结尾，经 USART1 DMA 发出。
+ * 双缓冲：一帧在 DMA 发送时，下一帧写另一块缓冲；已编好的帧还没发出时跳过本时隙，
+ * 到期信号顺延到下一时隙（不阻塞，也不丢差分）。
+ * 接收窗口：上一帧发完（或收完主站的一帧）后总线空闲满 TELEM_LISTEN_CHARS 个字符时间
+ * 才发下一帧（rs485_uart_bus_quiet，按 DWT 周期计时，不受 1ms 节拍取整），总线上正在收帧时顺延，
+ * 主站随时能插入请求（如写 0 停流）。帧间距 = 本帧实际编码长度的发送时间 + 接收窗口，
+ * 订阅少、差分压缩后帧短，能跑的周期也随之变短；周期比这还短时跳过时隙，不会排队。
+ *
+ * 帧（COBS 编码前，多字节小端）：
+ *   [0]    类型 TELEM_FRAME_KEY / TELEM_FRAME_DELTA
+ *   [1]    序号（每帧加1，上位机据此统计丢帧）
+ *   [2..3] 采样时刻 ms（低16位）
+ *   [4..7] 信号位图（bit i = telem_sig_t i 在本帧中）
+ *   [8..]  位图中的信号按编号升序：
+ *          关键帧为原值，宽度见下；
+ *          差分帧为与该信号上次发出值之差（按信号宽度回绕取有符号数），zig-zag 后 LEB128
+ *          变长编码（低 7 位在前，最高位=后面还有），变化小的量只占 1 字节
+ *   末2字节 CRC16/MODBUS
+ * 关键帧：每 TELEM_KEYFRAME_INTERVAL 帧开始新一轮，各信号在一轮中第一次出现时发关键帧；
+ *       新订阅的信号也立即发关键帧。
+ *       上位机发现序号不连续时丢弃差分基准，等关键帧重新同步。
+ * 信号：电流为补偿后的 ADC 码（u16），位置为霍尔/纹波计数（u32），
+ *       温度为 0.01℃（s16），加热占空比为 ‰（u16）。
+ *
+ * 订阅（每个信号一项，见 telemetry_subscribe）：
+ *   0                    不发送
+ *   1~TELEM_SUB_PERIOD_MAX  每 N ms 发送一次（按时隙取整，相位各自独立）
+ *   TELEM_SUB_ON_CHANGE  值变化的时隙才发送
+ * 只遍历已订阅信号的紧凑列表，组帧耗时与订阅数成正比；数值按宽度原样拷贝，无格式化。
+ * 初始化后全部信号每个时隙都发。
+ *
+ * 全信号关键帧 74 字节，差分编码不比原值短时改发关键帧，帧长不超过关键帧。
+ * 1kHz 时每帧连同接收窗口要在 1ms 内发完：全信号关键帧（COBS 后 76 字节 + 32 字符窗口）约需 1.1Mbaud，
+ * 全信号差分帧（典型约 40 字节）约 0.75Mbaud（USART1 在 APB2 上，最高 4.5Mbaud）；偶尔超时的
+ * 关键帧只让下一时隙跳过。
+ * 流式期间 Modbus 请求在帧后的接收窗口内发出，应答也在窗口内完成。
+ */
+#define TELEM_FRAME_KEY         0x01U
+#define TELEM_FRAME_DELTA       0x02U
+#define TELEM_KEYFRAME_INTERVAL 50U     // 帧
+#define TELEM_RAW_MAX           96U     // 编码前最大帧长
+#define TELEM_BUF_SIZE          (TELEM_RAW_MAX + TELEM_RAW_MAX / 254U + 2U)  // COBS 开销 + 结尾 0
+#define TELEM_PERIOD_MS_MAX     1000U
+#define TELEM_LISTEN_CHARS      32U     // 接收窗口：足够主站发出一条短请求（06/16 写停流）并开始应答
+#define TELEM_SUB_OFF           0U
+#define TELEM_SUB_PERIOD_MAX    60000U
+#define TELEM_SUB_ON_CHANGE     0xFFFFU
+
+typedef enum{
+    TELEM_SIG_CUR_M1 = 0, TELEM_SIG_CUR_M2, TELEM_SIG_CUR_M3,
+    TELEM_SIG_CUR_M4, TELEM_SIG_CUR_M5, TELEM_SIG_CUR_M6,
+    TELEM_SIG_CUR_HEAT1, TELEM_SIG_CUR_HEAT2,
+    TELEM_SIG_CUR_FAN1, TELEM_SIG_CUR_FAN2,
+    TELEM_SIG_POS_M1, TELEM_SIG_POS_M2, TELEM_SIG_POS_M3,
+    TELEM_SIG_POS_M4, TELEM_SIG_POS_M5, TELEM_SIG_POS_M6,
+    TELEM_SIG_TEMP1, TELEM_SIG_TEMP2,
+    TELEM_SIG_DUTY_H1, TELEM_SIG_DUTY_H2, TELEM_SIG_DUTY_H3, TELEM_SIG_DUTY_H4,
+    TELEM_SIG_DUTY_H5, TELEM_SIG_DUTY_H6, TELEM_SIG_DUTY_H7, TELEM_SIG_DUTY_H8,
+    TELEM_SIG_NUM
+}telem_sig_t;
+
+typedef struct{
+    uint32_t frames_sent;
+    uint32_t slots_skipped;     // 链路跟不上，上一帧还没发出，本时隙不组帧
+    uint32_t frames_key;        // 组出的关键帧数
+}telemetry_stats_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+#ifdef USE_RS485_COMM
+void telemetry_init(uint16_t period_ms);
+void telemetry_set_period_ms(uint16_t period_ms);
+uint16_t telemetry_get_period_ms(void);
+const volatile uint16_t *telemetry_period_table(void);
+void telemetry_subscribe(telem_sig_t sig, uint16_t sub);
+const volatile uint16_t *telemetry_sub_table(void);
+void telemetry_get_stats(telemetry_stats_t *stats);
+void telemetry_tick_1ms(void);
+#endif
+
+#endif // TELEMETRY_H
@@ -0,0 +1,324 @@
+#include "can_drv.h"
+#include "pin_cfg.h"
+#include "stm32f1xx_hal.h"
+
+#ifdef USE_CAN_COMM
+
+/***************************************************************
+ * 关键配置区
+ ***************************************************************/
+
+/**
+ * @brief 引脚：RX 上拉输入（未接总线时保持隐性，退出初始化不会卡住），TX 复用推挽
+ */
+#define CAN_RX_PINS(F, gpio, a, b)  ( F(CAN_RX_PORT, CAN_RX_PIN, gpio, a, b) )
+#define CAN_TX_PINS(F, gpio, a, b)  ( F(CAN_TX_PORT, CAN_TX_PIN, gpio, a, b) )
+
+static const pin_cfg_port_t s_can_pin_cfg[] = {
+    PIN_CFG_PORT(CAN_RX_PINS, GPIOB, PIN_CFG_IN_PULL,   CAN_RX_PINS(PIN_CFG_PIN_OF, GPIOB, 0, 0)),
+    PIN_CFG_PORT(CAN_TX_PINS, GPIOB, PIN_CFG_AF_PP_50M, 0U),
+};
+
+#define CAN_INIT_TIMEOUT        100000U                 // 等待 INAK 的轮询次数（约数毫秒）
+#define CAN_MB_NUM              3U
+#define CAN_MB_ALL              0x7U
+#define CAN_FILTER_IDE_RTR      ((1U << 2) | (1U << 1)) // 过滤器掩码里 IDE/RTR 也参与比较：只收标准数据帧
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static can_rx_cb_t s_rx_cb = 0;
+
+static can_frame_t s_txq[CAN_TX_QUEUE_LEN];     // 按 ID 升序（优先级从高到低）
+static uint8_t s_txq_len = 0;
+
+static can_frame_t s_mb[CAN_MB_NUM];            // 邮箱内容副本，被中止时放回队列
+static uint8_t s_mb_busy = 0;
+static uint8_t s_mb_abort = 0;
+
+static can_drv_stats_t s_stats;
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static void can_mb_load(uint8_t i, const can_frame_t *f)
+{
+    CAN_TxMailBox_TypeDef *mb = &CAN1->sTxMailBox[i];
+
+    s_mb[i] = *f;
+    s_mb_busy |= (uint8_t)(1U << i);
+
+    mb->TDTR = f->dlc;
+    mb->TDLR = (uint32_t)f->data[0] | ((uint32_t)f->data[1] << 8) | ((uint32_t)f->data[2] << 16) | ((uint32_t)f->data[3] << 24);
+    mb->TDHR = (uint32_t)f->data[4] | ((uint32_t)f->data[5] << 8) | ((uint32_t)f->data[6] << 16) | ((uint32_t)f->data[7] << 24);
+    mb->TIR  = ((uint32_t)f->id << CAN_TI0R_STID_Pos) | CAN_TI0R_TXRQ;
+}
+
+/**
+ * @brief 按 ID 插入队列（同 ID 排在已有帧之后），调用前确认未满
+ */
+static void can_txq_insert(const can_frame_t *f)
+{
+    uint8_t i = s_txq_len;
+
+    while(i > 0U && s_txq[i - 1U].id > f->id)
+    {
+        s_txq[i] = s_txq[i - 1U];
+        i--;
+    }
+    s_txq[i] = *f;
+    s_txq_len++;
+}
+
+/**
+ * @brief 队首依次补进空邮箱
+ */
+static void can_tx_fill(void)
+{
+    while(s_txq_len && s_mb_busy != CAN_MB_ALL)
+    {
+        uint8_t i = 0;
+
+        while(s_mb_busy & (1U << i)) i++;
+        can_mb_load(i, &s_txq[0]);
+
+        s_txq_len--;
+        for(uint8_t k = 0; k < s_txq_len; k++) s_txq[k] = s_txq[k + 1U];
+    }
+}
+
+/**
+ * @brief 邮箱全满且队首比邮箱里最低优先级的帧更急时，中止那一帧
+ * @note  同一时刻只中止一个；队列需留有放回被中止帧的空位
+ */
+static void can_tx_preempt(void)
+{
+    uint8_t victim = CAN_MB_NUM;
+
+    if(s_mb_busy != CAN_MB_ALL || s_mb_abort || s_txq_len == 0 || s_txq_len >= CAN_TX_QUEUE_LEN) return;
+
+    for(uint8_t i = 0; i < CAN_MB_NUM; i++)
+    {
+        if(victim == CAN_MB_NUM || s_mb[i].id > s_mb[victim].id) victim = i;
+    }
+    if(s_txq[0].id >= s_mb[victim].id) return;
+
+    s_mb_abort = (uint8_t)(1U << victim);
+    CAN1->TSR = CAN_TSR_ABRQ0 << (8U * victim);
+    s_stats.tx_preempted++;
+}
+
+static void can_rx_fifo(uint8_t fifo)
+{
+    volatile uint32_t *rfr = fifo ? &CAN1->RF1R : &CAN1->RF0R;     // RF0R/RF1R 位定义相同
+    CAN_FIFOMailBox_TypeDef *mb = &CAN1->sFIFOMailBox[fifo];
+    can_frame_t f;
+
+    if(*rfr & CAN_RF0R_FOVR0)
+    {
+        *rfr = CAN_RF0R_FOVR0;
+        s_stats.rx_overrun++;
+    }
+
+    while(*rfr & CAN_RF0R_FMP0)
+    {
+        uint32_t lo = mb->RDLR;
+        uint32_t hi = mb->RDHR;
+
+        f.id  = (uint16_t)((mb->RIR >> CAN_RI0R_STID_Pos) & 0x7FFU);
+        f.dlc = (uint8_t)(mb->RDTR & CAN_RDT0R_DLC);
+        if(f.dlc > 8U) f.dlc = 8U;
+        for(uint8_t k = 0; k < 4U; k++)
+        {
+            f.data[k] = (uint8_t)(lo >> (8U * k));
+            f.data[4U + k] = (uint8_t)(hi >> (8U * k));
+        }
+        *rfr = CAN_RF0R_RFOM0;      // 释放该报文，FIFO 下一帧前移
+
+        if(s_rx_cb) s_rx_cb(fifo, &f);
+    }
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化 CAN1，所有过滤器关闭（设置过滤器前不接收任何帧）
+ * @param bitrate 波特率，0=默认；需能被 CAN_CLK_HZ/CAN_TQ_PER_BIT 整除（1M/500k/250k/125k）
+ * @param cb      接收回调
+ * @return 1=成功，0=参数错误/控制器未应答
+ */
+uint8_t can_drv_init(uint32_t bitrate, can_rx_cb_t cb)
+{
+    uint32_t brp, t;
+
+    if(bitrate == 0) bitrate = CAN_BITRATE_DEFAULT;
+    brp = CAN_CLK_HZ / (bitrate * CAN_TQ_PER_BIT);
+    if(brp == 0 || brp > 1024U || brp * bitrate * CAN_TQ_PER_BIT != CAN_CLK_HZ) return 0;
+
+    s_rx_cb = cb;
+    s_txq_len = 0;
+    s_mb_busy = 0;
+    s_mb_abort = 0;
+    s_stats = (can_drv_stats_t){0};
+
+    // 先 remap 再配引脚。SWJ_CFG 只写、读回不确定，须和 heat_out_drv 一样重写为“关 JTAG 保留 SWD”，
+    // 否则读-改-写可能把 PA15/PB3/PB4 还给 JTAG
+    RCC->APB2ENR |= RCC_APB2ENR_AFIOEN;
+    (void)RCC->APB2ENR;
+    AFIO->MAPR = (AFIO->MAPR & ~(AFIO_MAPR_CAN_REMAP | AFIO_MAPR_SWJ_CFG))
+               | AFIO_MAPR_CAN_REMAP_REMAP2 | AFIO_MAPR_SWJ_CFG_JTAGDISABLE;
+
+    pin_cfg_apply(s_can_pin_cfg, (uint8_t)(sizeof(s_can_pin_cfg) / sizeof(s_can_pin_cfg[0])),
+                  CAN_RX_PINS(PIN_CFG_CLK_OF, 0, 0, 0) | CAN_TX_PINS(PIN_CFG_CLK_OF, 0, 0, 0));
+
+    RCC->APB1ENR |= RCC_APB1ENR_CAN1EN;
+    (void)RCC->APB1ENR;
+
+    CAN1->MCR = CAN_MCR_INRQ;                   // 退出睡眠，进入初始化
+    for(t = CAN_INIT_TIMEOUT; (CAN1->MSR & (CAN_MSR_INAK | CAN_MSR_SLAK)) != CAN_MSR_INAK; )
+    {
+        if(--t == 0) return 0;
+    }
+
+    // 自动离线恢复、自动唤醒、失败自动重发；TXFP=0：邮箱间按 ID 仲裁
+    CAN1->MCR = CAN_MCR_INRQ | CAN_MCR_ABOM | CAN_MCR_AWUM;
+    CAN1->BTR = ((CAN_SJW_TQ - 1U) << CAN_BTR_SJW_Pos) | ((CAN_BS2_TQ - 1U) << CAN_BTR_TS2_Pos)
+              | ((CAN_BS1_TQ - 1U) << CAN_BTR_TS1_Pos) | (brp - 1U);
+
+    CAN1->FMR |= CAN_FMR_FINIT;
+    CAN1->FA1R = 0;
+    CAN1->FMR &= ~CAN_FMR_FINIT;
+
+    CAN1->IER = CAN_IER_TMEIE | CAN_IER_FMPIE0 | CAN_IER_FOVIE0 | CAN_IER_FMPIE1 | CAN_IER_FOVIE1;
+
+    CAN1->MCR &= ~CAN_MCR_INRQ;                 // 检测到 11 个隐性位后进入正常模式
+    for(t = CAN_INIT_TIMEOUT; CAN1->MSR & CAN_MSR_INAK; )
+    {
+        if(--t == 0) return 0;
+    }
+
+    HAL_NVIC_SetPriority(USB_HP_CAN1_TX_IRQn, CAN_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USB_HP_CAN1_TX_IRQn);
+    HAL_NVIC_SetPriority(USB_LP_CAN1_RX0_IRQn, CAN_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USB_LP_CAN1_RX0_IRQn);
+    HAL_NVIC_SetPriority(CAN1_RX1_IRQn, CAN_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(CAN1_RX1_IRQn);
+    return 1;
+}
+
+/**
+ * @brief 设置一个过滤器组（32 位掩码模式，标准数据帧）
+ * @param bank 0~13
+ * @param id   期望 ID
+ * @param mask 参与比较的 ID 位（0x7FF=精确匹配）
+ * @param fifo 命中后进入的 FIFO（0/1）
+ * @return 1=成功
+ */
+uint8_t can_drv_set_filter(uint8_t bank, uint16_t id, uint16_t mask, uint8_t fifo)
+{
+    uint32_t bit = 1UL << bank;
+
+    if(bank >= CAN_FILTER_BANK_NUM || fifo > 1U) return 0;
+
+    CAN1->FMR |= CAN_FMR_FINIT;
+    CAN1->FA1R &= ~bit;
+    CAN1->FM1R &= ~bit;             // 掩码模式
+    CAN1->FS1R |= bit;              // 32 位
+    if(fifo) CAN1->FFA1R |= bit;
+    else     CAN1->FFA1R &= ~bit;
+    CAN1->sFilterRegister[bank].FR1 = (uint32_t)(id & 0x7FFU) << CAN_RI0R_STID_Pos;
+    CAN1->sFilterRegister[bank].FR2 = ((uint32_t)(mask & 0x7FFU) << CAN_RI0R_STID_Pos) | CAN_FILTER_IDE_RTR;
+    CAN1->FA1R |= bit;
+    CAN1->FMR &= ~CAN_FMR_FINIT;
+    return 1;
+}
+
+/**
+ * @brief 发送一帧（可在任务或中断里调用）
+ * @return 1=已进邮箱/队列，0=队列满或参数错误
+ */
+uint8_t can_drv_send(const can_frame_t *frame)
+{
+    if(frame == 0 || frame->dlc > 8U || frame->id > 0x7FFU) return 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    // 正在中止的邮箱帧可能要放回队列，为它预留一个位置
+    if(s_txq_len + (s_mb_abort ? 1U : 0U) >= CAN_TX_QUEUE_LEN)
+    {
+        s_stats.tx_dropped++;
+        __set_PRIMASK(primask);
+        return 0;
+    }
+    can_txq_insert(frame);
+    can_tx_fill();
+    can_tx_preempt();
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+void can_drv_get_stats(can_drv_stats_t *stats)
+{
+    if(stats) *stats = s_stats;
+}
+
+/**
+ * @brief 错误状态寄存器（TEC/REC/离线/被动等）
+ */
+uint32_t can_drv_get_esr(void)
+{
+    return CAN1->ESR;
+}
+
+/**
+ * @brief 发送邮箱空中断：回收邮箱、被中止的帧放回队列、补位
+ * @note  在 USB_HP_CAN1_TX_IRQHandler 中调用
+ */
+void can_drv_tx_irq_handler(void)
+{
+    uint32_t tsr = CAN1->TSR;
+
+    for(uint8_t i = 0; i < CAN_MB_NUM; i++)
+    {
+        uint32_t rqcp = CAN_TSR_RQCP0 << (8U * i);
+        uint8_t bit = (uint8_t)(1U << i);
+
+        if(!(tsr & rqcp)) continue;
+        CAN1->TSR = rqcp;           // 写1清 RQCP/TXOK/ALST/TERR
+
+        if(!(s_mb_busy & bit)) continue;
+        s_mb_busy &= (uint8_t)~bit;
+        // 中止时帧可能已经发出去了（TXOK=1），只有真正没发的才放回
+        if((s_mb_abort & bit) && !(tsr & (CAN_TSR_TXOK0 << (8U * i))))
+        {
+            if(s_txq_len < CAN_TX_QUEUE_LEN) can_txq_insert(&s_mb[i]);
+            else s_stats.tx_dropped++;
+        }
+        s_mb_abort &= (uint8_t)~bit;
+    }
+
+    can_tx_fill();
+    can_tx_preempt();
+}
+
+/**
+ * @note 在 USB_LP_CAN1_RX0_IRQHandler 中调用
+ */
+void can_drv_rx0_irq_handler(void)
+{
+    can_rx_fifo(0);
+}
+
+/**
+ * @note 在 CAN1_RX1_IRQHandler 中调用
+ */
+void can_drv_rx1_irq_handler(void)
+{
+    can_rx_fifo(1);
+}
+
+#endif // USE_CAN_COMM
@@ -0,0 +1,106 @@
+#include "can_proto.h"
+#include "reg_map.h"
+
+#ifdef USE_CAN_COMM
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static uint8_t s_node_id = CAN_NODE_ID_DEFAULT;
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint16_t be16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static modbus_ex_t can_proto_exec(const can_frame_t *req, can_frame_t *rsp)
+{
+    uint8_t fc = req->data[0];
+    uint16_t addr = be16(&req->data[1]);
+    uint8_t num = req->data[3];
+    modbus_ex_t ex;
+
+    if(req->dlc < 4U) return MODBUS_EX_ILLEGAL_VALUE;
+
+    switch(fc)
+    {
+        case 0x03:
+        case 0x04:
+            if(num == 0 || num > CAN_PROTO_READ_MAX) return MODBUS_EX_ILLEGAL_VALUE;
+            ex = reg_map_read((fc == 0x03) ? MODBUS_REG_HOLDING : MODBUS_REG_INPUT, addr, num, &rsp->data[2]);
+            if(ex != MODBUS_EX_NONE) return ex;
+            rsp->data[1] = num;
+            rsp->dlc = (uint8_t)(2U + num * 2U);
+            return MODBUS_EX_NONE;
+
+        case 0x10:
+            if(num == 0 || num > CAN_PROTO_WRITE_MAX || req->dlc != 4U + num * 2U) return MODBUS_EX_ILLEGAL_VALUE;
+            ex = reg_map_write(addr, num, &req->data[4]);
+            if(ex != MODBUS_EX_NONE) return ex;
+            for(uint8_t i = 1; i < 4U; i++) rsp->data[i] = req->data[i];
+            rsp->dlc = 4;
+            return MODBUS_EX_NONE;
+
+        default:
+            return MODBUS_EX_ILLEGAL_FUNCTION;
+    }
+}
+
+/**
+ * @brief 接收回调：过滤器保证只会收到本节点请求（FIFO0）和广播（FIFO1）
+ */
+static void can_proto_on_frame(uint8_t fifo, const can_frame_t *frame)
+{
+    can_frame_t rsp;
+    modbus_ex_t ex;
+
+    if(fifo == 1U)
+    {
+        if(frame->data[0] == 0x10) (void)can_proto_exec(frame, &rsp);
+        return;
+    }
+
+    rsp.id = (uint16_t)(CAN_PROTO_RSP_BASE + s_node_id);
+    rsp.data[0] = frame->data[0];
+    ex = can_proto_exec(frame, &rsp);
+    if(ex != MODBUS_EX_NONE)
+    {
+        rsp.data[0] = (uint8_t)(frame->data[0] | 0x80U);
+        rsp.data[1] = (uint8_t)ex;
+        rsp.dlc = 2;
+    }
+    (void)can_drv_send(&rsp);
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化 CAN 并设置本节点的硬件过滤器
+ * @param node_id 1~127，越界用默认值
+ * @param bitrate 0=默认
+ * @return 1=成功，0=CAN 控制器初始化失败
+ */
+uint8_t can_proto_init(uint8_t node_id, uint32_t bitrate)
+{
+    if(node_id == 0 || node_id > CAN_PROTO_NODE_MAX) node_id = CAN_NODE_ID_DEFAULT;
+    s_node_id = node_id;
+
+    if(!can_drv_init(bitrate, can_proto_on_frame)) return 0;
+    can_drv_set_filter(0, (uint16_t)(CAN_PROTO_REQ_BASE + node_id), 0x7FFU, 0);
+    can_drv_set_filter(1, CAN_PROTO_BCAST_ID, 0x7FFU, 1);
+    return 1;
+}
+
+uint8_t can_proto_get_node_id(void)
+{
+    return s_node_id;
+}
+
+#endif // USE_CAN_COMM
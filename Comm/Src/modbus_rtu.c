@@ -0,0 +1,191 @@
+#include "modbus_rtu.h"
+#include "rs485_uart.h"
+#include "crc.h"
+
+#ifdef USE_RS485_COMM
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static uint8_t s_addr = MODBUS_ADDR_DEFAULT;
+static const modbus_rtu_regs_t *s_regs = 0;
+static uint8_t s_tx[MODBUS_ADU_MAX];            // 应答缓冲，DMA 发送期间不可改写
+static modbus_rtu_stats_t s_stats;
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint16_t be16(const uint8_t *p)
+{
+    return (uint16_t)(((uint16_t)p[0] << 8) | p[1]);
+}
+
+static void put_be16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v >> 8);
+    p[1] = (uint8_t)v;
+}
+
+/**
+ * @brief 补 CRC（低字节在前）并启动发送
+ */
+static void modbus_send(uint16_t len)
+{
+    uint16_t crc = crc16_modbus(s_tx, len);
+
+    s_tx[len] = (uint8_t)crc;
+    s_tx[len + 1U] = (uint8_t)(crc >> 8);
+    rs485_uart_send(s_tx, (uint16_t)(len + 2U));
+}
+
+static void modbus_send_exception(uint8_t fc, modbus_ex_t ex)
+{
+    s_stats.exceptions++;
+    s_tx[1] = (uint8_t)(fc | 0x80U);
+    s_tx[2] = (uint8_t)ex;
+    modbus_send(3);
+}
+
+/**
+ * @brief FC03/04：应答数据由回调直接写进 s_tx[3..]
+ */
+static modbus_ex_t modbus_fc_read(const uint8_t *req, uint16_t len, modbus_reg_type_t type, uint16_t *rsp_len)
+{
+    if(len != 8U) return MODBUS_EX_ILLEGAL_VALUE;
+
+    uint16_t start = be16(&req[2]);
+    uint16_t num = be16(&req[4]);
+
+    if(num == 0 || num > MODBUS_READ_MAX) return MODBUS_EX_ILLEGAL_VALUE;
+    if((uint32_t)start + num > 0x10000UL) return MODBUS_EX_ILLEGAL_ADDRESS;
+    if(s_regs == 0 || s_regs->read == 0) return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    modbus_ex_t ex = s_regs->read(type, start, num, &s_tx[3]);
+    if(ex != MODBUS_EX_NONE) return ex;
+
+    s_tx[2] = (uint8_t)(num * 2U);
+    *rsp_len = (uint16_t)(3U + num * 2U);
+    return MODBUS_EX_NONE;
+}
+
+/**
+ * @brief FC06：应答 = 请求原样回显
+ */
+static modbus_ex_t modbus_fc_write_single(const uint8_t *req, uint16_t len, uint16_t *rsp_len)
+{
+    if(len != 8U) return MODBUS_EX_ILLEGAL_VALUE;
+    if(s_regs == 0 || s_regs->write == 0) return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    modbus_ex_t ex = s_regs->write(be16(&req[2]), 1, &req[4]);
+    if(ex != MODBUS_EX_NONE) return ex;
+
+    for(int i = 2; i < 6; i++) s_tx[i] = req[i];
+    *rsp_len = 6;
+    return MODBUS_EX_NONE;
+}
+
+/**
+ * @brief FC16：应答 = 起始地址 + 数量
+ */
+static modbus_ex_t modbus_fc_write_multi(const uint8_t *req, uint16_t len, uint16_t *rsp_len)
+{
+    if(len < 11U) return MODBUS_EX_ILLEGAL_VALUE;
+
+    uint16_t start = be16(&req[2]);
+    uint16_t num = be16(&req[4]);
+    uint8_t  bytes = req[6];
+
+    if(num == 0 || num > MODBUS_WRITE_MAX || bytes != num * 2U || len != 9U + bytes) return MODBUS_EX_ILLEGAL_VALUE;
+    if((uint32_t)start + num > 0x10000UL) return MODBUS_EX_ILLEGAL_ADDRESS;
+    if(s_regs == 0 || s_regs->write == 0) return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    modbus_ex_t ex = s_regs->write(start, num, &req[7]);
+    if(ex != MODBUS_EX_NONE) return ex;
+
+    put_be16(&s_tx[2], start);
+    put_be16(&s_tx[4], num);
+    *rsp_len = 6;
+    return MODBUS_EX_NONE;
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化从站并启动 RS485 收发
+ * @param addr 从站地址 1~247
+ * @param baud 波特率，0=默认
+ * @param regs 寄存器访问回调（需长期有效）
+ */
+void modbus_rtu_init(uint8_t addr, uint32_t baud, const modbus_rtu_regs_t *regs)
+{
+    modbus_rtu_set_addr(addr);
+    s_regs = regs;
+    s_stats = (modbus_rtu_stats_t){0};
+    rs485_uart_init(baud, modbus_rtu_on_frame);
+}
+
+void modbus_rtu_set_addr(uint8_t addr)
+{
+    if(addr == 0 || addr > 247U) addr = MODBUS_ADDR_DEFAULT;
+    s_addr = addr;
+}
+
+uint8_t modbus_rtu_get_addr(void)
+{
+    return s_addr;
+}
+
+void modbus_rtu_get_stats(modbus_rtu_stats_t *stats)
+{
+    if(stats) *stats = s_stats;
+}
+
+/**
+ * @brief 处理一帧请求（rs485_uart 的接收回调，USART1 中断里调用）
+ */
+void modbus_rtu_on_frame(const uint8_t *frame, uint16_t len)
+{
+    uint8_t addr, fc;
+    uint16_t rsp_len = 0;
+    modbus_ex_t ex;
+
+    if(len < 4U || len > MODBUS_ADU_MAX) return;
+    addr = frame[0];
+    if(addr != s_addr && addr != 0U) return;   // 先比地址，别的从站的帧不算 CRC
+
+    if(crc16_modbus(frame, (uint16_t)(len - 2U)) != (uint16_t)(frame[len - 2U] | ((uint16_t)frame[len - 1U] << 8)))
+    {
+        s_stats.crc_errors++;
+        return;
+    }
+    s_stats.rx_frames++;
+
+    if(rs485_uart_is_busy())
+    {
+        s_stats.tx_busy++;
+        return;
+    }
+
+    fc = frame[1];
+    s_tx[0] = s_addr;
+    s_tx[1] = fc;
+
+    switch(fc)
+    {
+        case 0x03: ex = (addr == 0U) ? MODBUS_EX_ILLEGAL_FUNCTION : modbus_fc_read(frame, len, MODBUS_REG_HOLDING, &rsp_len); break;
+        case 0x04: ex = (addr == 0U) ? MODBUS_EX_ILLEGAL_FUNCTION : modbus_fc_read(frame, len, MODBUS_REG_INPUT, &rsp_len);   break;
+        case 0x06: ex = modbus_fc_write_single(frame, len, &rsp_len); break;
+        case 0x10: ex = modbus_fc_write_multi(frame, len, &rsp_len);  break;
+        default:   ex = MODBUS_EX_ILLEGAL_FUNCTION;                   break;
+    }
+
+    if(addr == 0U) return;      // 广播不应答
+    if(ex != MODBUS_EX_NONE) modbus_send_exception(fc, ex);
+    else                     modbus_send(rsp_len);
+}
+
+#endif // USE_RS485_COMM
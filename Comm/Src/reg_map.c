@@ -0,0 +1,282 @@
+#include "reg_map.h"
+#include "stm32f1xx_hal.h"
+#include "adc_frame.h"
+#include "temp_sense.h"
+#include "motor_drv.h"
+#include "heat_pwm.h"
+#include "fan_ctrl.h"
+#include "telemetry.h"
+
+/***************************************************************
+ * 内部类型
+ ***************************************************************/
+
+typedef const volatile void *(*reg_map_base_t)(void);
+typedef void (*reg_map_set_t)(uint8_t index, uint32_t value);
+
+/**
+ * @brief 一段连续寄存器 ↔ 一个内存数组（或结构体数组中的同一字段）
+ */
+typedef struct{
+    uint8_t  type;          // modbus_reg_type_t
+    uint16_t addr;          // 起始寄存器地址
+    uint8_t  num;           // 元素数
+    uint8_t  width;         // 元素内存宽度（字节）：1/2/4
+    uint8_t  regs;          // 每元素寄存器数：1，或 2（仅 width=4，高字在前）
+    uint8_t  stride;        // 相邻元素间距（字节）
+    reg_map_base_t base;    // 返回首元素地址（快照类数据每次请求取最新缓冲）
+    reg_map_set_t  set;     // 写入接口，NULL=只读
+    uint32_t max;           // 写入上限（含），超出返回非法数值
+}reg_map_block_t;
+
+#define REG_ARRAY(type, addr, num, elem_t, regs, base, set, max) \
+    { (type), (addr), (num), sizeof(elem_t), (regs), sizeof(elem_t), (base), (set), (max) }
+
+#define REG_FIELD(type, addr, num, struct_t, field, regs, base) \
+    { (type), (addr), (num), sizeof(((struct_t *)0)->field), (regs), sizeof(struct_t), (base), 0, 0 }
+
+/***************************************************************
+ * 数据源与写入接口
+ ***************************************************************/
+
+static const volatile void *src_adc(void)          { return adc_frame_latest(); }
+static const volatile void *src_temp(void)         { return &temp_sense_live()[0].temp_centi; }
+static const volatile void *src_temp_rate(void)    { return &temp_sense_live()[0].rate_centi_s; }
+static const volatile void *src_temp_status(void)  { return &temp_sense_live()[0].status; }
+static const volatile void *src_fan_duty(void)     { return fan_pwm_permille_table(); }
+static const volatile void *src_heat_duty(void)    { return heat_pwm_permille_table(); }
+static const volatile void *src_motor_dir(void)    { return motor_drv_dir_table(); }
+#ifdef USE_RS485_COMM
+static const volatile void *src_telem_period(void) { return telemetry_period_table(); }
+static const volatile void *src_telem_sub(void)    { return telemetry_sub_table(); }
+#endif
+
+/**
+ * @brief 位置计数：经 motor_drv_pos_get_count 取值（含霍尔稳定期/接管判定），与遥测同口径
+ */
+static const volatile void *src_hall(void)
+{
+    static uint32_t pos[MOTOR_NUM];
+
+    for(int i = 0; i < MOTOR_NUM; i++) pos[i] = motor_drv_pos_get_count((motor_id_t)i);
+    return pos;
+}
+
+static void set_heat_duty(uint8_t i, uint32_t v)   { heat_pwm_set_permille((heat_out_ch_t)i, (uint16_t)v); }
+static void set_motor_dir(uint8_t i, uint32_t v)   { motor_drv_set_dir((motor_id_t)i, (motor_dir_t)v); }
+#ifdef USE_RS485_COMM
+static void set_telem_period(uint8_t i, uint32_t v) { (void)i; telemetry_set_period_ms((uint16_t)v); }
+static void set_telem_sub(uint8_t i, uint32_t v)    { telemetry_subscribe((telem_sig_t)i, (uint16_t)v); }
+#endif
+
+static void set_fan_manual(uint8_t i, uint32_t v)
+{
+    fan_ctrl_set_manual((fan_id_t)i, (uint16_t)v);
+    fan_ctrl_set_mode((fan_id_t)i, FAN_CTRL_MANUAL);
+}
+
+/***************************************************************
+ * 映射表（按 type、addr 升序，块之间不重叠）
+ ***************************************************************/
+
+static const reg_map_block_t s_blocks[] = {
+    REG_ARRAY(MODBUS_REG_HOLDING, REG_MAP_HOLD_HEAT_DUTY,  HEAT_OUT_NUM, uint16_t,    1, src_heat_duty, set_heat_duty,  HEAT_PWM_PERMILLE_MAX),
+    REG_ARRAY(MODBUS_REG_HOLDING, REG_MAP_HOLD_MOTOR_DIR,  MOTOR_NUM,    motor_dir_t, 1, src_motor_dir, set_motor_dir,  MOTOR_DIR_REV),
+    REG_ARRAY(MODBUS_REG_HOLDING, REG_MAP_HOLD_FAN_MANUAL, FAN_NUM,      uint16_t,    1, src_fan_duty,  set_fan_manual, FAN_PWM_PERMILLE_MAX),
+#ifdef USE_RS485_COMM
+    REG_ARRAY(MODBUS_REG_HOLDING, REG_MAP_HOLD_TELEM_PERIOD, 1,          uint16_t,    1, src_telem_period, set_telem_period, TELEM_PERIOD_MS_MAX),
+    REG_ARRAY(MODBUS_REG_HOLDING, REG_MAP_HOLD_TELEM_SUB,  TELEM_SIG_NUM, uint16_t,   1, src_telem_sub, set_telem_sub,  TELEM_SUB_ON_CHANGE),
+#endif
+
+    REG_ARRAY(MODBUS_REG_INPUT, REG_MAP_IN_ADC,      ADC_FRAME_CH_NUM, uint16_t, 1, src_adc,      0, 0),
+    REG_ARRAY(MODBUS_REG_INPUT, REG_MAP_IN_HALL,     MOTOR_NUM,        uint32_t, 2, src_hall,     0, 0),
+    REG_FIELD(MODBUS_REG_INPUT, REG_MAP_IN_TEMP,        TEMP_SENSE_CH_NUM, temp_sense_reading_t, temp_centi,   2, src_temp),
+    REG_FIELD(MODBUS_REG_INPUT, REG_MAP_IN_TEMP_RATE,   TEMP_SENSE_CH_NUM, temp_sense_reading_t, rate_centi_s, 2, src_temp_rate),
+    REG_FIELD(MODBUS_REG_INPUT, REG_MAP_IN_TEMP_STATUS, TEMP_SENSE_CH_NUM, temp_sense_reading_t, status,       1, src_temp_status),
+    REG_ARRAY(MODBUS_REG_INPUT, REG_MAP_IN_FAN_DUTY, FAN_NUM,          uint16_t, 1, src_fan_duty, 0, 0),
+};
+
+#define REG_MAP_BLOCK_NUM   (sizeof(s_blocks) / sizeof(s_blocks[0]))
+
+static const modbus_rtu_regs_t s_modbus_regs = { reg_map_read, reg_map_write };
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint16_t reg_map_span(const reg_map_block_t *b)
+{
+    return (uint16_t)(b->num * b->regs);
+}
+
+/**
+ * @brief 找到包含 addr 的块
+ * @return 块指针，落在空洞/越界返回 NULL
+ */
+static const reg_map_block_t *reg_map_find(uint8_t type, uint16_t addr)
+{
+    for(const reg_map_block_t *b = s_blocks; b < &s_blocks[REG_MAP_BLOCK_NUM]; b++)
+    {
+        if(b->type != type) continue;
+        if(addr < b->addr) return 0;
+        if(addr < b->addr + reg_map_span(b)) return b;
+    }
+    return 0;
+}
+
+/**
+ * @brief 逐块遍历 [addr, addr+num)，要求各段首尾相接地落在同类型的块里
+ * @param b   首块（reg_map_find 的结果）
+ * @param off 输出：当前块内寄存器偏移；n 输出：本块内寄存器数
+ * @return 下一块；范围不连续返回 NULL
+ */
+static const reg_map_block_t *reg_map_next(const reg_map_block_t *b, uint8_t type, uint16_t addr, uint16_t num,
+                                           uint16_t *off, uint16_t *n)
+{
+    if(b == &s_blocks[REG_MAP_BLOCK_NUM] || b->type != type || addr < b->addr || addr >= b->addr + reg_map_span(b)) return 0;
+
+    *off = (uint16_t)(addr - b->addr);
+    *n = (uint16_t)(reg_map_span(b) - *off);
+    if(*n > num) *n = num;
+    return b + 1;
+}
+
+/**
+ * @brief 把块内 [off, off+n) 个寄存器按大端写入 out
+ * @note  16 位连续数组：一次读 32 位、REV16 后一次写出，两个寄存器一条指令；
+ *        32 位元素：一次 REV 即得到高字在前的两个寄存器。
+ *        源数组只保证 2 字节对齐、out 可能是奇地址，M3 的 LDR/STR 支持非对齐访问。
+ */
+static void reg_map_copy(const reg_map_block_t *b, uint16_t off, uint16_t n, uint8_t *out)
+{
+    const uint8_t *p = (const uint8_t *)b->base();
+
+    if(b->width == 2U && b->stride == 2U)
+    {
+        p += off * 2U;
+        for(; n >= 2U; n -= 2U, p += 4, out += 4)
+        {
+            __UNALIGNED_UINT32_WRITE(out, __REV16(__UNALIGNED_UINT32_READ(p)));
+        }
+        if(n)
+        {
+            uint16_t v = *(const uint16_t *)p;
+            out[0] = (uint8_t)(v >> 8);
+            out[1] = (uint8_t)v;
+        }
+        return;
+    }
+
+    if(b->regs == 2U)
+    {
+        p += (off >> 1) * b->stride;
+        if(off & 1U)                            // 从元素的低字开始
+        {
+            uint32_t v = *(const uint32_t *)p;
+            out[0] = (uint8_t)(v >> 8);
+            out[1] = (uint8_t)v;
+            out += 2; p += b->stride; n--;
+        }
+        for(; n >= 2U; n -= 2U, p += b->stride, out += 4)
+        {
+            __UNALIGNED_UINT32_WRITE(out, __REV(*(const uint32_t *)p));
+        }
+        if(n)                                   // 只取元素的高字
+        {
+            uint32_t v = *(const uint32_t *)p;
+            out[0] = (uint8_t)(v >> 24);
+            out[1] = (uint8_t)(v >> 16);
+        }
+        return;
+    }
+
+    p += off * b->stride;
+    for(; n; n--, p += b->stride, out += 2)
+    {
+        uint16_t v = (b->width == 1U) ? *p : (b->width == 2U) ? *(const uint16_t *)p : (uint16_t)*(const uint32_t *)p;
+        out[0] = (uint8_t)(v >> 8);
+        out[1] = (uint8_t)v;
+    }
+}
+
+static uint32_t reg_map_value(const reg_map_block_t *b, const uint8_t *in)
+{
+    uint32_t v = ((uint32_t)in[0] << 8) | in[1];
+
+    if(b->regs == 2U) v = (v << 16) | ((uint32_t)in[2] << 8) | in[3];
+    return v;
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 读寄存器（modbus_rtu_regs_t.read）
+ */
+modbus_ex_t reg_map_read(modbus_reg_type_t type, uint16_t addr, uint16_t num, uint8_t *out)
+{
+    const reg_map_block_t *b = reg_map_find((uint8_t)type, addr);
+    uint16_t off, n;
+
+    if(b == 0) return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    while(num)
+    {
+        const reg_map_block_t *cur = b;
+
+        b = reg_map_next(cur, (uint8_t)type, addr, num, &off, &n);
+        if(b == 0) return MODBUS_EX_ILLEGAL_ADDRESS;
+        reg_map_copy(cur, off, n, out);
+        out += n * 2U;
+        addr = (uint16_t)(addr + n);
+        num = (uint16_t)(num - n);
+    }
+    return MODBUS_EX_NONE;
+}
+
+/**
+ * @brief 写保持寄存器（modbus_rtu_regs_t.write）
+ * @note  先整体校验（地址、可写、32 位元素不拆写、数值上限），全部通过才逐元素写入，
+ *        不会出现写了一半返回异常的情况
+ */
+modbus_ex_t reg_map_write(uint16_t addr, uint16_t num, const uint8_t *in)
+{
+    const reg_map_block_t *first = reg_map_find(MODBUS_REG_HOLDING, addr);
+    const reg_map_block_t *b, *cur;
+    uint16_t a, left, off, n;
+    const uint8_t *p;
+
+    if(first == 0) return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    for(b = first, a = addr, left = num, p = in; left; a = (uint16_t)(a + n), left = (uint16_t)(left - n), p += n * 2U)
+    {
+        cur = b;
+        b = reg_map_next(cur, MODBUS_REG_HOLDING, a, left, &off, &n);
+        if(b == 0 || cur->set == 0) return MODBUS_EX_ILLEGAL_ADDRESS;
+        if(cur->regs == 2U && ((off | n) & 1U)) return MODBUS_EX_ILLEGAL_ADDRESS;
+        for(uint16_t i = 0; i < n; i += cur->regs)
+        {
+            if(reg_map_value(cur, p + i * 2U) > cur->max) return MODBUS_EX_ILLEGAL_VALUE;
+        }
+    }
+
+    for(b = first, a = addr, left = num, p = in; left; a = (uint16_t)(a + n), left = (uint16_t)(left - n), p += n * 2U)
+    {
+        cur = b;
+        b = reg_map_next(cur, MODBUS_REG_HOLDING, a, left, &off, &n);
+        for(uint16_t i = 0; i < n; i += cur->regs)
+        {
+            cur->set((uint8_t)((off + i) / cur->regs), reg_map_value(cur, p + i * 2U));
+        }
+    }
+    return MODBUS_EX_NONE;
+}
+
+/**
+ * @brief 供 modbus_rtu_init 使用的回调表
+ */
+const modbus_rtu_regs_t *reg_map_modbus_regs(void)
+{
+    return &s_modbus_regs;
+}
@@ -0,0 +1,257 @@
+#include "rs485_uart.h"
+#include "pin_cfg.h"
+#include "stm32f1xx_hal.h"
+
+#ifdef USE_RS485_COMM
+
+/***************************************************************
+ * 关键配置区
+ ***************************************************************/
+
+#define RS485_UART_CLK_HZ       SYSTEM_CLOCK_FREQ      // USART1 在 APB2（72MHz）
+#define RS485_RX_DMA            DMA1_Channel5
+#define RS485_TX_DMA            DMA1_Channel4
+
+/**
+ * @brief 引脚：TX 复用推挽，RX 上拉输入（总线空闲时防止浮空误触发），DE 推挽且上电为低（接收）
+ */
+#define RS485_TX_PINS(F, gpio, a, b)  ( F(RS485_TX_PORT, RS485_TX_PIN, gpio, a, b) )
+#define RS485_RX_PINS(F, gpio, a, b)  ( F(RS485_RX_PORT, RS485_RX_PIN, gpio, a, b) )
+#define RS485_DE_PINS(F, gpio, a, b)  ( F(RS485_DE_PORT, RS485_DE_PIN, gpio, a, b) )
+
+static const pin_cfg_port_t s_rs485_pin_cfg[] = {
+    PIN_CFG_PORT(RS485_DE_PINS, GPIOA, PIN_CFG_OUT_PP_50M, RS485_DE_PINS(PIN_CFG_PIN_OF, GPIOA, 0, 0) << 16),
+    PIN_CFG_PORT(RS485_RX_PINS, GPIOA, PIN_CFG_IN_PULL,    RS485_RX_PINS(PIN_CFG_PIN_OF, GPIOA, 0, 0)),
+    PIN_CFG_PORT(RS485_TX_PINS, GPIOA, PIN_CFG_AF_PP_50M,  0U),
+};
+
+#define RS485_DE_HIGH()     (RS485_DE_PORT->BSRR = RS485_DE_PIN)
+#define RS485_DE_LOW()      (RS485_DE_PORT->BSRR = (uint32_t)RS485_DE_PIN << 16)
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static uint8_t s_rx_ring[RS485_RX_RING_SIZE];
+static uint8_t s_rx_linear[RS485_RX_RING_SIZE];     // 帧跨环尾时拼接用
+static uint16_t s_rx_pos = 0;                       // 上一帧结束时 DMA 的写位置
+static rs485_rx_cb_t s_rx_cb = 0;
+static rs485_tx_done_cb_t s_tx_done_cb = 0;
+static volatile uint8_t s_tx_busy = 0;
+static uint32_t s_baud = RS485_BAUD_DEFAULT;
+static uint32_t s_char_cyc = 0;                     // 一个字符时间（8N1，10 位）的 CPU 周期数
+static volatile uint32_t s_quiet_cyc = 0;           // 总线最近一次转为空闲时的 DWT 周期计数
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint16_t rs485_rx_dma_pos(void)
+{
+    return (uint16_t)(RS485_RX_RING_SIZE - RS485_RX_DMA->CNDTR);
+}
+
+/**
+ * @brief 总线上是否有正在接收、还没结束（未到 IDLE）的帧
+ */
+static uint8_t rs485_rx_active(void)
+{
+    uint16_t pos = rs485_rx_dma_pos();
+
+    if(pos == RS485_RX_RING_SIZE) pos = 0;
+    return pos != s_rx_pos;
+}
+
+/**
+ * @brief 一帧结束：取出上一位置到当前写位置之间的数据交给上层
+ */
+static void rs485_rx_frame(void)
+{
+    uint16_t pos = rs485_rx_dma_pos();
+    uint16_t start = s_rx_pos;
+    uint16_t len;
+
+    if(pos == RS485_RX_RING_SIZE) pos = 0;
+    s_rx_pos = pos;
+    s_quiet_cyc = DWT->CYCCNT;
+    if(pos == start || s_tx_busy || s_rx_cb == 0) return;
+
+    if(pos > start)
+    {
+        s_rx_cb(&s_rx_ring[start], (uint16_t)(pos - start));
+        return;
+    }
+
+    len = (uint16_t)(RS485_RX_RING_SIZE - start);
+    for(uint16_t i = 0; i < len; i++) s_rx_linear[i] = s_rx_ring[start + i];
+    for(uint16_t i = 0; i < pos; i++)  s_rx_linear[len + i] = s_rx_ring[i];
+    s_rx_cb(s_rx_linear, (uint16_t)(len + pos));
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化 USART1 + DMA 收发，DE 为低（接收）
+ * @param baud 波特率（8N1）
+ * @param cb   收到一帧的回调
+ */
+void rs485_uart_init(uint32_t baud, rs485_rx_cb_t cb)
+{
+    s_rx_cb = cb;
+    s_baud = baud ? baud : RS485_BAUD_DEFAULT;
+    s_rx_pos = 0;
+    s_tx_busy = 0;
+    s_char_cyc = (RS485_UART_CLK_HZ * 10U + s_baud - 1U) / s_baud;
+
+    // 空闲计时用 DWT 周期计数器
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    s_quiet_cyc = DWT->CYCCNT;
+
+    pin_cfg_apply(s_rs485_pin_cfg, (uint8_t)(sizeof(s_rs485_pin_cfg) / sizeof(s_rs485_pin_cfg[0])),
+                  RS485_DE_PINS(PIN_CFG_CLK_OF, 0, 0, 0) | RS485_RX_PINS(PIN_CFG_CLK_OF, 0, 0, 0)
+                  | RS485_TX_PINS(PIN_CFG_CLK_OF, 0, 0, 0));
+
+    RCC->APB2ENR |= RCC_APB2ENR_USART1EN;
+    RCC->AHBENR  |= RCC_AHBENR_DMA1EN;
+    (void)RCC->AHBENR;
+
+    USART1->CR1 = 0;
+    USART1->CR2 = 0;
+    USART1->CR3 = USART_CR3_DMAR | USART_CR3_DMAT;
+    USART1->BRR = (RS485_UART_CLK_HZ + s_baud / 2U) / s_baud;
+
+    // 接收：外设->内存，字节，循环，高优先级
+    RS485_RX_DMA->CCR = 0;
+    RS485_RX_DMA->CPAR = (uint32_t)&USART1->DR;
+    RS485_RX_DMA->CMAR = (uint32_t)s_rx_ring;
+    RS485_RX_DMA->CNDTR = RS485_RX_RING_SIZE;
+    RS485_RX_DMA->CCR = DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_PL_1 | DMA_CCR_EN;
+
+    // 发送：内存->外设，字节，传输完成中断；每次发送时再填地址和长度
+    RS485_TX_DMA->CCR = 0;
+    RS485_TX_DMA->CPAR = (uint32_t)&USART1->DR;
+    RS485_TX_DMA->CCR = DMA_CCR_MINC | DMA_CCR_DIR | DMA_CCR_TCIE | DMA_CCR_PL_0;
+
+    USART1->CR1 = USART_CR1_UE | USART_CR1_TE | USART_CR1_RE | USART_CR1_IDLEIE;
+
+    HAL_NVIC_SetPriority(USART1_IRQn, RS485_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+    HAL_NVIC_SetPriority(DMA1_Channel4_IRQn, RS485_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel4_IRQn);
+}
+
+/**
+ * @brief 启动 DMA 发送
+ * @param buf 发送完成前必须保持有效
+ * @return 1=已启动，0=上一帧还在发送/参数错误
+ */
+uint8_t rs485_uart_send(const uint8_t *buf, uint16_t len)
+{
+    if(buf == 0 || len == 0) return 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(s_tx_busy)
+    {
+        __set_PRIMASK(primask);
+        return 0;
+    }
+    s_tx_busy = 1;
+    __set_PRIMASK(primask);
+
+    RS485_DE_HIGH();
+    RS485_TX_DMA->CCR &= ~DMA_CCR_EN;
+    RS485_TX_DMA->CMAR = (uint32_t)buf;
+    RS485_TX_DMA->CNDTR = len;
+    DMA1->IFCR = DMA_IFCR_CGIF4;
+    USART1->SR = (uint32_t)~USART_SR_TC;    // 写0清 TC
+    RS485_TX_DMA->CCR |= DMA_CCR_EN;
+    return 1;
+}
+
+void rs485_uart_set_tx_done_cb(rs485_tx_done_cb_t cb)
+{
+    s_tx_done_cb = cb;
+}
+
+uint8_t rs485_uart_is_busy(void)
+{
+    return s_tx_busy;
+}
+
+/**
+ * @brief 总线是否已空闲至少 chars 个字符时间：不在发送、没有正在接收的帧，
+ *        且距上次发送结束/收完一帧已过 chars 个字符时间
+ * @note  发送方用它在帧间给主站留接收窗口；查询间隔需小于 RS485_QUIET_CLAMP_CYC
+ */
+uint8_t rs485_uart_bus_quiet(uint16_t chars)
+{
+    uint8_t quiet = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(!s_tx_busy && !rs485_rx_active())
+    {
+        uint32_t now = DWT->CYCCNT;
+        uint32_t elapsed = now - s_quiet_cyc;
+
+        if(elapsed > RS485_QUIET_CLAMP_CYC)
+        {
+            elapsed = RS485_QUIET_CLAMP_CYC;
+            s_quiet_cyc = now - RS485_QUIET_CLAMP_CYC;
+        }
+        quiet = (elapsed >= (uint32_t)chars * s_char_cyc);
+    }
+    __set_PRIMASK(primask);
+    return quiet;
+}
+
+uint32_t rs485_uart_get_baud(void)
+{
+    return s_baud;
+}
+
+/**
+ * @brief USART1 中断：IDLE=一帧结束；TC=最后一个字节已移出，释放 DE
+ * @note  在 USART1_IRQHandler 中调用
+ */
+void rs485_uart_irq_handler(void)
+{
+    uint32_t sr = USART1->SR;
+
+    if(sr & (USART_SR_IDLE | USART_SR_ORE | USART_SR_FE | USART_SR_NE))
+    {
+        (void)USART1->DR;               // 先读 SR 再读 DR，清 IDLE/错误标志
+        if(sr & USART_SR_IDLE) rs485_rx_frame();
+    }
+
+    if((USART1->CR1 & USART_CR1_TCIE) && (sr & USART_SR_TC))
+    {
+        USART1->CR1 &= ~USART_CR1_TCIE;
+        RS485_DE_LOW();
+        s_rx_pos = rs485_rx_dma_pos();  // 丢弃发送期间 RX 上的内容
+        if(s_rx_pos == RS485_RX_RING_SIZE) s_rx_pos = 0;
+        s_quiet_cyc = DWT->CYCCNT;
+        s_tx_busy = 0;
+        if(s_tx_done_cb) s_tx_done_cb();
+    }
+}
+
+/**
+ * @brief DMA1 通道4 中断：数据已全部写入 USART，改等 TC
+ * @note  在 DMA1_Channel4_IRQHandler 中调用
+ */
+void rs485_uart_tx_dma_irq_handler(void)
+{
+    if(DMA1->ISR & DMA_ISR_TCIF4)
+    {
+        DMA1->IFCR = DMA_IFCR_CGIF4;
+        RS485_TX_DMA->CCR &= ~DMA_CCR_EN;
+        USART1->CR1 |= USART_CR1_TCIE;
+    }
+}
+
+#endif // USE_RS485_COMM
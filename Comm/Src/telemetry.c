@@ -0,0 +1,438 @@
+#include "telemetry.h"
+#include "rs485_uart.h"
+#include "crc.h"
+#include "stm32f1xx_hal.h"
+#include "adc_frame.h"
+#include "temp_sense.h"
+#include "motor_drv.h"
+#include "heat_pwm.h"
+
+#ifdef USE_RS485_COMM
+
+/***************************************************************
+ * 内部类型
+ ***************************************************************/
+
+typedef struct{
+    uint32_t (*get)(uint8_t arg);
+    uint8_t arg;
+    uint8_t width;      // 帧内字节数：2/4
+}telem_sig_def_t;
+
+/***************************************************************
+ * 信号表
+ ***************************************************************/
+
+static uint32_t sig_adc(uint8_t ch)  { return adc_frame_latest()[ch]; }
+static uint32_t sig_pos(uint8_t id)  { return motor_drv_pos_get_count((motor_id_t)id); }
+static uint32_t sig_duty(uint8_t ch) { return heat_pwm_get_permille((heat_out_ch_t)ch); }
+
+static uint32_t sig_temp(uint8_t ch)
+{
+    int32_t t = temp_sense_live()[ch].temp_centi;
+
+    if(t > INT16_MAX) t = INT16_MAX;
+    if(t < INT16_MIN) t = INT16_MIN;
+    return (uint16_t)(int16_t)t;
+}
+
+// X(信号, 取值函数, 参数, 帧内字节数)；表和帧长上限都由这里展开，加信号只改这一处
+#define TELEM_SIG_LIST(X) \
+    X(TELEM_SIG_CUR_M1,    sig_adc,  ADC_FRAME_MOTOR1_CURRENT, 2) \
+    X(TELEM_SIG_CUR_M2,    sig_adc,  ADC_FRAME_MOTOR2_CURRENT, 2) \
+    X(TELEM_SIG_CUR_M3,    sig_adc,  ADC_FRAME_MOTOR3_CURRENT, 2) \
+    X(TELEM_SIG_CUR_M4,    sig_adc,  ADC_FRAME_MOTOR4_CURRENT, 2) \
+    X(TELEM_SIG_CUR_M5,    sig_adc,  ADC_FRAME_MOTOR5_CURRENT, 2) \
+    X(TELEM_SIG_CUR_M6,    sig_adc,  ADC_FRAME_MOTOR6_CURRENT, 2) \
+    X(TELEM_SIG_CUR_HEAT1, sig_adc,  ADC_FRAME_HEAT_CURRENT1,  2) \
+    X(TELEM_SIG_CUR_HEAT2, sig_adc,  ADC_FRAME_HEAT_CURRENT2,  2) \
+    X(TELEM_SIG_CUR_FAN1,  sig_adc,  ADC_FRAME_FAN1_CURRENT,   2) \
+    X(TELEM_SIG_CUR_FAN2,  sig_adc,  ADC_FRAME_FAN2_CURRENT,   2) \
+    X(TELEM_SIG_POS_M1,    sig_pos,  MOTOR1,                   4) \
+    X(TELEM_SIG_POS_M2,    sig_pos,  MOTOR2,                   4) \
+    X(TELEM_SIG_POS_M3,    sig_pos,  MOTOR3,                   4) \
+    X(TELEM_SIG_POS_M4,    sig_pos,  MOTOR4,                   4) \
+    X(TELEM_SIG_POS_M5,    sig_pos,  MOTOR5,                   4) \
+    X(TELEM_SIG_POS_M6,    sig_pos,  MOTOR6,                   4) \
+    X(TELEM_SIG_TEMP1,     sig_temp, TEMP_SENSE_NTC1,          2) \
+    X(TELEM_SIG_TEMP2,     sig_temp, TEMP_SENSE_NTC2,          2) \
+    X(TELEM_SIG_DUTY_H1,   sig_duty, HEAT_OUT1,                2) \
+    X(TELEM_SIG_DUTY_H2,   sig_duty, HEAT_OUT2,                2) \
+    X(TELEM_SIG_DUTY_H3,   sig_duty, HEAT_OUT3,                2) \
+    X(TELEM_SIG_DUTY_H4,   sig_duty, HEAT_OUT4,                2) \
+    X(TELEM_SIG_DUTY_H5,   sig_duty, HEAT_OUT5,                2) \
+    X(TELEM_SIG_DUTY_H6,   sig_duty, HEAT_OUT6,                2) \
+    X(TELEM_SIG_DUTY_H7,   sig_duty, HEAT_OUT7,                2) \
+    X(TELEM_SIG_DUTY_H8,   sig_duty, HEAT_OUT8,                2)
+
+#define TELEM_SIG_ENTRY(sig, get, arg, width)   [sig] = { get, arg, width },
+#define TELEM_SIG_WIDTH(sig, get, arg, width)   + (width)
+#define TELEM_SIG_COUNT(sig, get, arg, width)   + 1
+
+#define TELEM_PAYLOAD_MAX       (0 TELEM_SIG_LIST(TELEM_SIG_WIDTH))    // 全信号原值负载字节数
+
+static const telem_sig_def_t s_sig[TELEM_SIG_NUM] = {
+    TELEM_SIG_LIST(TELEM_SIG_ENTRY)
+};
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static uint8_t s_raw[TELEM_RAW_MAX];
+static uint8_t s_buf[2][TELEM_BUF_SIZE];
+static uint16_t s_len[2];
+static volatile int8_t s_tx = -1;       // DMA 正在发送的缓冲，-1=无
+static volatile int8_t s_ready = -1;    // 已编好等待发送的缓冲，-1=无
+
+static volatile uint16_t s_period_ms = 0;
+static uint16_t s_tick_ms = 0;
+static uint16_t s_stamp_ms = 0;         // 相对上一时隙经过的 ms，用于订阅倒计时
+
+// 订阅：s_sub 供外部改写；s_sub_pending 标记改过的信号，节拍里统一重建紧凑列表，
+// 避免 USART 中断里的写入与组帧时的遍历冲突
+static volatile uint16_t s_sub[TELEM_SIG_NUM];
+static uint16_t s_sub_cur[TELEM_SIG_NUM];   // 节拍里取走的快照，组帧只看它
+static volatile uint32_t s_sub_pending = 0;
+static uint8_t s_active[TELEM_SIG_NUM];    // 已订阅信号，按编号升序
+static uint8_t s_active_num = 0;
+static int32_t s_left[TELEM_SIG_NUM];      // 周期订阅：距下次发送的 ms；变化订阅：0=强制发一次
+static uint32_t s_last[TELEM_SIG_NUM];     // 上次发出的值：变化判断与差分基准
+
+// 差分压缩：s_synced 为本轮关键帧之后已以原值发过的信号，不在其中的信号到期时必须发关键帧
+static uint8_t s_due[TELEM_SIG_NUM];       // 本时隙到期信号及其采样值
+static uint32_t s_val[TELEM_SIG_NUM];
+static uint32_t s_synced = 0;
+static uint16_t s_since_key = 0;
+
+static uint8_t s_seq = 0;
+static telemetry_stats_t s_stats;
+
+_Static_assert(TELEM_SIG_NUM <= 32, "signal bitmap is one 32-bit word");
+_Static_assert((0 TELEM_SIG_LIST(TELEM_SIG_COUNT)) == TELEM_SIG_NUM, "every signal needs a table entry");
+// 头 8 + 全信号原值 + 差分试编码越过原值长度时最多多写的 4 字节 + CRC 2
+_Static_assert(8 + TELEM_PAYLOAD_MAX + 4 + 2 <= TELEM_RAW_MAX, "worst-case frame must fit in TELEM_RAW_MAX");
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+/**
+ * @brief COBS 编码并补结尾 0x00
+ * @return 输出长度（含结尾 0）
+ */
+static uint16_t telem_cobs_encode(const uint8_t *in, uint16_t len, uint8_t *out)
+{
+    uint16_t code_pos = 0, o = 1;
+    uint8_t code = 1;
+
+    for(uint16_t i = 0; i < len; i++)
+    {
+        if(in[i] == 0U)
+        {
+            out[code_pos] = code;
+            code_pos = o++;
+            code = 1;
+            continue;
+        }
+        out[o++] = in[i];
+        if(++code == 0xFFU)
+        {
+            out[code_pos] = code;
+            code_pos = o++;
+            code = 1;
+        }
+    }
+    out[code_pos] = code;
+    out[o++] = 0;
+    return o;
+}
+
+/**
+ * @brief 写入一个差分值：按信号宽度取有符号差，zig-zag 后按 7 位一组变长输出
+ * @note  u16 信号最多 3 字节，u32 最多 5 字节
+ */
+static uint8_t *telem_put_delta(uint8_t *p, uint32_t diff, uint8_t width)
+{
+    int32_t d = (width == 2U) ? (int16_t)(uint16_t)diff : (int32_t)diff;
+    uint32_t z = ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+
+    while(z >= 0x80U)
+    {
+        *p++ = (uint8_t)(z | 0x80U);
+        z >>= 7;
+    }
+    *p++ = (uint8_t)z;
+    return p;
+}
+
+/**
+ * @brief 取走待处理的订阅修改：改过的信号从下一时隙重新起算（先发一次原值），并重建紧凑列表
+ */
+static void telem_apply_sub(void)
+{
+    uint32_t primask, pending;
+    uint8_t n = 0;
+
+    // 标记与取值在同一临界区内，快照不会与 pending 不一致
+    primask = __get_PRIMASK();
+    __disable_irq();
+    pending = s_sub_pending;
+    s_sub_pending = 0;
+    for(uint8_t i = 0; i < TELEM_SIG_NUM; i++)
+    {
+        if(pending & (1UL << i)) s_sub_cur[i] = s_sub[i];
+    }
+    __set_PRIMASK(primask);
+
+    if(pending == 0U) return;
+    s_synced &= ~pending;
+
+    for(uint8_t i = 0; i < TELEM_SIG_NUM; i++)
+    {
+        if(pending & (1UL << i)) s_left[i] = 0;
+        if(s_sub_cur[i] != TELEM_SUB_OFF) s_active[n++] = i;
+    }
+    s_active_num = n;
+}
+
+/**
+ * @brief 采样本时隙到期的信号，组成编码前的帧
+ * @param elapsed 距上一时隙的 ms
+ * @return 帧长，0=没有到期信号
+ * @note  先定出到期信号，再决定发关键帧还是差分帧。关键帧数值统一按 4 字节小端写入、
+ *        指针按信号宽度前进，多写的高字节被下一个信号或 CRC 覆盖；差分帧每个信号最多 5 字节，
+ *        组帧耗时有上界
+ */
+static uint16_t telem_build(uint8_t *raw, uint16_t elapsed)
+{
+    uint32_t now = HAL_GetTick();
+    uint32_t map = 0;
+    uint8_t *p = &raw[8];
+    uint8_t ndue = 0, key;
+    uint16_t raw_len = 0, n, crc;        // raw_len：到期信号的原值负载字节数
+
+    for(uint8_t k = 0; k < s_active_num; k++)
+    {
+        uint8_t i = s_active[k];
+        uint16_t sub = s_sub_cur[i];
+        const telem_sig_def_t *s = &s_sig[i];
+        uint32_t v;
+
+        if(sub == TELEM_SUB_ON_CHANGE)
+        {
+            v = s->get(s->arg);
+            if(s_left[i] != 0 && v == s_last[i]) continue;
+            s_left[i] = 1;
+        }
+        else
+        {
+            s_left[i] -= elapsed;
+            if(s_left[i] > 0) continue;
+            s_left[i] += sub;               // 保持相位，不因时隙取整而漂移
+            if(s_left[i] <= 0) s_left[i] = sub;
+            v = s->get(s->arg);
+        }
+        s_due[ndue] = i;
+        s_val[ndue++] = v;
+        raw_len += s->width;
+        map |= 1UL << i;
+    }
+
+    if(map == 0U) return 0;
+
+    // 每 TELEM_KEYFRAME_INTERVAL 帧开始新一轮，各信号在本轮第一次出现时以原值发送
+    if(++s_since_key >= TELEM_KEYFRAME_INTERVAL) s_synced = 0;
+    key = (map & ~s_synced) != 0U;
+
+    // 先试差分编码，不比原值短（噪声大、跳变大）就改发关键帧
+    if(!key)
+    {
+        for(uint8_t k = 0; k < ndue; k++)
+        {
+            uint8_t i = s_due[k];
+
+            p = telem_put_delta(p, s_val[k] - s_last[i], s_sig[i].width);
+            if(p - &raw[8] >= raw_len)
+            {
+                key = 1;
+                break;
+            }
+        }
+    }
+
+    if(key)
+    {
+        p = &raw[8];
+        for(uint8_t k = 0; k < ndue; k++)
+        {
+            __UNALIGNED_UINT32_WRITE(p, s_val[k]);
+            p += s_sig[s_due[k]].width;
+        }
+        s_synced |= map;
+        s_since_key = 0;
+        s_stats.frames_key++;
+    }
+
+    for(uint8_t k = 0; k < ndue; k++)
+    {
+        s_last[s_due[k]] = s_val[k];
+    }
+
+    raw[0] = key ? TELEM_FRAME_KEY : TELEM_FRAME_DELTA;
+    raw[1] = s_seq++;
+    raw[2] = (uint8_t)now;
+    raw[3] = (uint8_t)(now >> 8);
+    __UNALIGNED_UINT32_WRITE(&raw[4], map);
+
+    n = (uint16_t)(p - raw);
+    crc = crc16_modbus(raw, n);
+    raw[n++] = (uint8_t)crc;
+    raw[n++] = (uint8_t)(crc >> 8);
+    return n;
+}
+
+/**
+ * @brief 发送完成（USART1 中断）：之后的接收窗口由 rs485_uart_bus_quiet 计时
+ * @note  Modbus 应答发完也会进来，此时 s_tx 为 -1
+ */
+static void telem_on_tx_done(void)
+{
+    if(s_tx >= 0)
+    {
+        s_stats.frames_sent++;
+        s_tx = -1;
+    }
+}
+
+/**
+ * @brief 总线已空闲 TELEM_LISTEN_CHARS 个字符时间（上一帧发完或主站请求收完之后）时，发出待发帧
+ * @note  主站的请求正在接收时不算空闲，遥测不会打断它
+ */
+static void telem_try_send(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(s_tx < 0 && s_ready >= 0 && rs485_uart_bus_quiet(TELEM_LISTEN_CHARS)
+       && rs485_uart_send(s_buf[s_ready], s_len[s_ready]))
+    {
+        s_tx = s_ready;
+        s_ready = -1;
+    }
+    __set_PRIMASK(primask);
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 启动遥测
+ * @param period_ms 发帧周期，0=关闭
+ * @note  链路由 rs485_uart_init（通常经 modbus_rtu_init）预先初始化
+ */
+void telemetry_init(uint16_t period_ms)
+{
+    s_tx = -1;
+    s_ready = -1;
+    s_tick_ms = 0;
+    s_stamp_ms = 0;
+    s_synced = 0;
+    s_since_key = 0;
+    s_stats = (telemetry_stats_t){0};
+    for(uint8_t i = 0; i < TELEM_SIG_NUM; i++) telemetry_subscribe((telem_sig_t)i, 1);
+    rs485_uart_set_tx_done_cb(telem_on_tx_done);
+    telemetry_set_period_ms(period_ms);
+}
+
+/**
+ * @brief 设置发帧周期
+ * @param period_ms 0=停止，超过 TELEM_PERIOD_MS_MAX 按上限
+ * @note  比链路能发的还快时，上一帧没发出的时隙跳过（计入 slots_skipped），实际帧率由帧长和接收窗口决定
+ */
+void telemetry_set_period_ms(uint16_t period_ms)
+{
+    if(period_ms > TELEM_PERIOD_MS_MAX) period_ms = TELEM_PERIOD_MS_MAX;
+    s_period_ms = period_ms;
+}
+
+uint16_t telemetry_get_period_ms(void)
+{
+    return s_period_ms;
+}
+
+/**
+ * @brief 周期的只读视图（供寄存器映射读取）
+ */
+const volatile uint16_t *telemetry_period_table(void)
+{
+    return &s_period_ms;
+}
+
+/**
+ * @brief 设置单个信号的订阅
+ * @param sub TELEM_SUB_OFF / 周期 ms（超过 TELEM_SUB_PERIOD_MAX 按上限） / TELEM_SUB_ON_CHANGE
+ * @note  可在中断中调用（Modbus 写寄存器），下一时隙生效
+ */
+void telemetry_subscribe(telem_sig_t sig, uint16_t sub)
+{
+    uint32_t primask;
+
+    if(sig >= TELEM_SIG_NUM) return;
+    if(sub > TELEM_SUB_PERIOD_MAX && sub != TELEM_SUB_ON_CHANGE) sub = TELEM_SUB_PERIOD_MAX;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    s_sub[sig] = sub;
+    s_sub_pending |= 1UL << sig;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 订阅表的只读视图（按 telem_sig_t 下标，供寄存器映射读取）
+ */
+const volatile uint16_t *telemetry_sub_table(void)
+{
+    return s_sub;
+}
+
+void telemetry_get_stats(telemetry_stats_t *stats)
+{
+    if(stats) *stats = s_stats;
+}
+
+/**
+ * @brief 1ms 节拍（SysTick 中调用）：每个时隙采样到期信号并编码，总线空闲够一个接收窗口则发送
+ */
+void telemetry_tick_1ms(void)
+{
+    uint16_t len;
+    int8_t idx;
+
+    if(s_stamp_ms < UINT16_MAX) s_stamp_ms++;
+    telem_try_send();
+
+    if(s_period_ms == 0) return;
+    if(++s_tick_ms < s_period_ms) return;
+    s_tick_ms = 0;
+
+    // 上一帧还没发出：本时隙不组帧，到期信号留到下一时隙（s_stamp_ms 继续累计），差分基准不丢
+    if(s_ready >= 0)
+    {
+        s_stats.slots_skipped++;
+        return;
+    }
+
+    telem_apply_sub();
+    len = telem_build(s_raw, s_stamp_ms);
+    s_stamp_ms = 0;
+    if(len == 0U) return;
+
+    // 取不在发送中的那块缓冲（s_ready 只在本节拍里改，这里一定为 -1）
+    idx = (s_tx == 0) ? 1 : 0;
+    s_len[idx] = telem_cobs_encode(s_raw, len, s_buf[idx]);
+    s_ready = idx;
+    telem_try_send();
+}
+
+#endif // USE_RS485_COMM
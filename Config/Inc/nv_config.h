@@ -0,0 +1,56 @@
+#ifndef NV_CONFIG_H
+#define NV_CONFIG_H
+
+#include <stdint.h>
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 非易失配置区
+ * 占用 flash 最后一页（2KB，见 STM32F103XX_FLASH.ld 的 NVCFG 区），
+ * 整页保存一份 nv_config_t，带魔数/版本/长度/CRC32 校验，校验不过就用默认值（全0）。
+ *
+ * 注意：擦写期间 CPU 取指会被 flash 挂起（擦除约 20~40ms），中断也会推迟，
+ *       只应在标定/维护时调用 nv_config_save，调用前先关掉加热输出。
+ */
+#define NV_CONFIG_FLASH_ADDR    0x0803F800U
+#define NV_CONFIG_PAGE_SIZE     2048U
+#define NV_CONFIG_MAGIC         0x4E56434FU     // "NVCO"
+#define NV_CONFIG_VERSION       3U      // v2：校验改为硬件 CRC32（见 crc.h）；v3：追加 vrefint_mv
+
+#define NV_CONFIG_NTC_NUM       2U      // 与 NTC1/NTC2 对应
+
+/**
+ * @brief 单路NTC的 Steinhart–Hart 标定结果
+ * 1/T = a + b·ln(R) + c·ln(R)^3（T 单位K，R 单位Ω）
+ */
+typedef struct{
+    uint32_t valid;         // 1 = 已标定
+    float    a;
+    float    b;
+    float    c;
+    uint16_t raw[3];        // 标定点ADC原始值（留档）
+    uint16_t reserved;
+    int32_t  ref_centi[3];  // 标定点参考温度（0.01℃）
+}nv_ntc_cal_t;
+
+/**
+ * @brief 配置内容（只追加字段，改布局时升版本号）
+ */
+typedef struct{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t size;          // sizeof(nv_config_t)
+    nv_ntc_cal_t ntc_cal[NV_CONFIG_NTC_NUM];
+    uint16_t vrefint_mv;    // Vrefint 标定值（mV），0=未标定，用 ADC_VREFINT_MV
+    uint16_t reserved;
+    uint32_t crc;           // 前面所有字的 CRC32（STM32 硬件算法）
+}nv_config_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+uint8_t nv_config_init(void);
+const nv_config_t *nv_config_get(void);
+uint8_t nv_config_save(const nv_config_t *cfg);
+
+#endif // NV_CONFIG_H
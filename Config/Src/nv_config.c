@@ -0,0 +1,112 @@
+#include "nv_config.h"
+#include "stm32f1xx_hal.h"
+#include "crc.h"
+#include <stddef.h>
+#include <string.h>
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static nv_config_t s_config;    // RAM 副本，读取都走这里
+
+_Static_assert(sizeof(nv_config_t) <= NV_CONFIG_PAGE_SIZE, "nv_config_t must fit in one flash page");
+_Static_assert(sizeof(nv_config_t) % 4U == 0U, "nv_config_t is programmed word by word");
+_Static_assert(offsetof(nv_config_t, crc) % 4U == 0U, "CRC covers whole words");
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+/**
+ * @brief 硬件 CRC32，覆盖 crc 字段之前的所有字
+ * @return 1=成功，0=CRC 计算出错（crc 未写）
+ */
+static uint8_t nv_config_calc_crc(const nv_config_t *cfg, uint32_t *crc)
+{
+    return crc32_hw((const uint32_t *)cfg, (uint32_t)offsetof(nv_config_t, crc) / 4U, crc);
+}
+
+static void nv_config_defaults(nv_config_t *cfg)
+{
+    memset(cfg, 0, sizeof(*cfg));
+    cfg->magic = NV_CONFIG_MAGIC;
+    cfg->version = NV_CONFIG_VERSION;
+    cfg->size = (uint16_t)sizeof(nv_config_t);
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 从 flash 加载配置
+ * @return 1=加载成功，0=配置区空白/损坏/版本不符/CRC 计算出错，已使用默认值
+ */
+uint8_t nv_config_init(void)
+{
+    const nv_config_t *flash = (const nv_config_t *)NV_CONFIG_FLASH_ADDR;
+    uint32_t crc;
+
+    if(flash->magic == NV_CONFIG_MAGIC
+       && flash->version == NV_CONFIG_VERSION
+       && flash->size == sizeof(nv_config_t)
+       && nv_config_calc_crc(flash, &crc)
+       && flash->crc == crc)
+    {
+        s_config = *flash;
+        return 1;
+    }
+
+    nv_config_defaults(&s_config);
+    return 0;
+}
+
+const nv_config_t *nv_config_get(void)
+{
+    return &s_config;
+}
+
+/**
+ * @brief 保存配置：擦除整页后按字写入，写完回读校验
+ * @param cfg 新配置（magic/version/size/crc 由本函数填写）
+ * @return 1=成功，0=CRC 计算出错（未擦写 flash）或擦写、校验失败（RAM 副本仍为新配置）
+ */
+uint8_t nv_config_save(const nv_config_t *cfg)
+{
+    FLASH_EraseInitTypeDef erase = {0};
+    uint32_t page_err = 0;
+    uint8_t ok = 1;
+
+    s_config = *cfg;
+    s_config.magic = NV_CONFIG_MAGIC;
+    s_config.version = NV_CONFIG_VERSION;
+    s_config.size = (uint16_t)sizeof(nv_config_t);
+    if(!nv_config_calc_crc(&s_config, &s_config.crc)) return 0;
+
+    erase.TypeErase = FLASH_TYPEERASE_PAGES;
+    erase.PageAddress = NV_CONFIG_FLASH_ADDR;
+    erase.NbPages = 1;
+
+    HAL_FLASH_Unlock();
+    if(HAL_FLASHEx_Erase(&erase, &page_err) != HAL_OK)
+    {
+        ok = 0;
+    }
+    else
+    {
+        const uint32_t *src = (const uint32_t *)&s_config;
+        for(uint32_t i = 0; i < (sizeof(nv_config_t) + 3U) / 4U; i++)
+        {
+            if(HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, NV_CONFIG_FLASH_ADDR + i * 4U, src[i]) != HAL_OK)
+            {
+                ok = 0;
+                break;
+            }
+        }
+    }
+    HAL_FLASH_Lock();
+
+    if(ok && memcmp((const void *)NV_CONFIG_FLASH_ADDR, &s_config, sizeof(nv_config_t)) != 0) ok = 0;
+    return ok;
+}
@@ -22,6 +22,15 @@
 #include "stm32f1xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "adc_frame.h"
+#include "motor_hall_pm.h"
+#include "heat_pwm.h"
+#include "heat_pid.h"
+#include "heat_guard.h"
+#include "fan_ctrl.h"
+#include "rs485_uart.h"
+#include "can_drv.h"
+#include "telemetry.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -187,6 +196,14 @@ void SysTick_Handler(void)
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+  motor_hall_pm_tick_1ms();
+  heat_guard_tick_1ms();
+  heat_pid_tick_1ms();
+  heat_pwm_tick();
+  fan_ctrl_tick_1ms();
+#ifdef USE_RS485_COMM
+  telemetry_tick_1ms();
+#endif
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -214,4 +231,56 @@ void EXTI15_10_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA1 channel1 global interrupt (ADC1 frame stream).
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  adc_frame_dma_irq_handler();
+}
+
+#ifdef USE_RS485_COMM
+/**
+  * @brief This function handles USART1 global interrupt (RS485 frame end / TX complete).
+  */
+void USART1_IRQHandler(void)
+{
+  rs485_uart_irq_handler();
+}
+
+/**
+  * @brief This function handles DMA1 channel4 global interrupt (RS485 TX).
+  */
+void DMA1_Channel4_IRQHandler(void)
+{
+  rs485_uart_tx_dma_irq_handler();
+}
+#endif
+
+#ifdef USE_CAN_COMM
+/**
+  * @brief This function handles CAN1 TX interrupt (mailbox empty).
+  */
+void USB_HP_CAN1_TX_IRQHandler(void)
+{
+  can_drv_tx_irq_handler();
+}
+
+/**
+  * @brief This function handles CAN1 RX0 interrupt (FIFO0: node requests).
+  */
+void USB_LP_CAN1_RX0_IRQHandler(void)
+{
+  can_drv_rx0_irq_handler();
+}
+
+/**
+  * @brief This function handles CAN1 RX1 interrupt (FIFO1: broadcast).
+  */
+void CAN1_RX1_IRQHandler(void)
+{
+  can_drv_rx1_irq_handler();
+}
+#endif
+
 /* USER CODE END 1 */
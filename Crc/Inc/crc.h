@@ -0,0 +1,54 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief CRC 计算
+ * CRC16/MODBUS（反射多项式 0xA001，初值 0xFFFF）：256 项查表，每字节一次查表一次移位，
+ *   供 Modbus RTU 与遥测帧使用，可在中断中调用。
+ * CRC32：用片上 CRC 单元，数据由 DMA2 通道1 以存储器到存储器方式按字喂入，CPU 不参与搬运，
+ *   供 flash 镜像、配置块校验使用。算法是 STM32 硬件 CRC（多项式 0x04C11DB7，初值 0xFFFFFFFF，
+ *   不反射，无结果异或，按小端 32 位字输入），与 IEEE 802.3 CRC32 结果不同，
+ *   上位机/打包工具需按同一算法计算。
+ *   CRC 单元只有一个且不可重入，只在初始化/主循环里用，不要在中断里用。
+ *
+ * 性能对比见 crc_bench_run（需定义 CRC_BENCH）。
+ */
+#define CRC32_HW_DMA_MAX_WORDS  65535U  // DMA 单次最多搬运的字数，超出时自动分段
+
+#define CRC32_HW_BUSY           0U      // crc32_hw_poll 返回值：还在计算
+#define CRC32_HW_DONE           1U      //                      完成，结果有效
+#define CRC32_HW_ERROR          2U      //                      DMA 传输错误，结果无效
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+uint16_t crc16_modbus(const uint8_t *data, uint16_t len);
+
+void crc32_hw_start(const uint32_t *data, uint32_t words);
+uint8_t crc32_hw_poll(uint32_t *crc);
+uint8_t crc32_hw(const uint32_t *data, uint32_t words, uint32_t *crc);
+
+#ifdef CRC_BENCH
+/**
+ * @brief 基准测试结果（DWT 周期数，测量期间关中断）
+ */
+typedef struct{
+    uint32_t crc16_bitwise;     // CRC16，CRC_BENCH_CRC16_LEN 字节
+    uint32_t crc16_nibble;      // 16 项半字节表
+    uint32_t crc16_table;       // 256 项表（crc16_modbus）
+    uint32_t crc32_sw_bitwise;  // CRC32，CRC_BENCH_CRC32_LEN 字节，软件逐位（同硬件算法）
+    uint32_t crc32_hw_cpu;      // CRC 单元，CPU 逐字写入
+    uint32_t crc32_hw_dma;      // CRC 单元，DMA 喂数（crc32_hw）
+    uint8_t  match;             // 1=各实现结果一致
+}crc_bench_t;
+
+#define CRC_BENCH_CRC16_LEN     256U
+#define CRC_BENCH_CRC32_LEN     1024U
+
+void crc_bench_run(crc_bench_t *out);
+#endif
+
+#endif // CRC_H
@@ -0,0 +1,126 @@
+#include "crc.h"
+#include "stm32f1xx_hal.h"
+
+#ifdef CRC_BENCH
+
+/**
+ * @brief CRC 各实现的耗时对比（在 CMake 的 target_compile_definitions 里加 CRC_BENCH 启用）
+ * 上电后在主循环前调用一次 crc_bench_run，用调试器查看结果。
+ * 数据放在 RAM；DMA 从 flash 取数时还要加上 flash 等待周期。
+ */
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static uint32_t s_data[CRC_BENCH_CRC32_LEN / 4U];
+
+/***************************************************************
+ * 对照实现
+ ***************************************************************/
+
+/**
+ * @brief CRC16/MODBUS，逐位计算（原 Modbus/遥测的实现）
+ */
+static uint16_t bench_crc16_bitwise(const uint8_t *data, uint16_t len)
+{
+    uint16_t crc = 0xFFFFU;
+
+    while(len--)
+    {
+        crc ^= *data++;
+        for(int i = 0; i < 8; i++)
+        {
+            crc = (crc & 1U) ? (uint16_t)((crc >> 1) ^ 0xA001U) : (uint16_t)(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief CRC16/MODBUS，16 项半字节表，每字节查两次
+ */
+static uint16_t bench_crc16_nibble(const uint8_t *data, uint16_t len)
+{
+    static const uint16_t table[16] = {
+        0x0000, 0xCC01, 0xD801, 0x1400, 0xF001, 0x3C00, 0x2800, 0xE401,
+        0xA001, 0x6C00, 0x7800, 0xB401, 0x5000, 0x9C01, 0x8801, 0x4400,
+    };
+    uint16_t crc = 0xFFFFU;
+
+    while(len--)
+    {
+        crc ^= *data++;
+        crc = (uint16_t)((crc >> 4) ^ table[crc & 0x0FU]);
+        crc = (uint16_t)((crc >> 4) ^ table[crc & 0x0FU]);
+    }
+    return crc;
+}
+
+/**
+ * @brief 与 CRC 单元相同算法的软件逐位实现
+ */
+static uint32_t bench_crc32_bitwise(const uint32_t *data, uint32_t words)
+{
+    uint32_t crc = 0xFFFFFFFFU;
+
+    while(words--)
+    {
+        crc ^= *data++;
+        for(int i = 0; i < 32; i++)
+        {
+            crc = (crc & 0x80000000U) ? ((crc << 1) ^ 0x04C11DB7U) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief CRC 单元，CPU 逐字写入
+ */
+static uint32_t bench_crc32_hw_cpu(const uint32_t *data, uint32_t words)
+{
+    RCC->AHBENR |= RCC_AHBENR_CRCEN;
+    CRC->CR = CRC_CR_RESET;
+    while(words--) CRC->DR = *data++;
+    return CRC->DR;
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 依次测量各实现，每项测量期间关中断
+ */
+void crc_bench_run(crc_bench_t *out)
+{
+    const uint8_t *bytes = (const uint8_t *)s_data;
+    uint32_t primask, t0;
+    uint16_t c16[3];
+    uint32_t c32[3];
+    uint8_t ok32;
+
+    for(uint32_t i = 0; i < CRC_BENCH_CRC32_LEN / 4U; i++) s_data[i] = i * 0x9E3779B9U;
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    t0 = DWT->CYCCNT; c16[0] = bench_crc16_bitwise(bytes, CRC_BENCH_CRC16_LEN); out->crc16_bitwise = DWT->CYCCNT - t0;
+    t0 = DWT->CYCCNT; c16[1] = bench_crc16_nibble(bytes, CRC_BENCH_CRC16_LEN);  out->crc16_nibble  = DWT->CYCCNT - t0;
+    t0 = DWT->CYCCNT; c16[2] = crc16_modbus(bytes, CRC_BENCH_CRC16_LEN);        out->crc16_table   = DWT->CYCCNT - t0;
+
+    t0 = DWT->CYCCNT; c32[0] = bench_crc32_bitwise(s_data, CRC_BENCH_CRC32_LEN / 4U); out->crc32_sw_bitwise = DWT->CYCCNT - t0;
+    t0 = DWT->CYCCNT; c32[1] = bench_crc32_hw_cpu(s_data, CRC_BENCH_CRC32_LEN / 4U);  out->crc32_hw_cpu     = DWT->CYCCNT - t0;
+    t0 = DWT->CYCCNT; ok32   = crc32_hw(s_data, CRC_BENCH_CRC32_LEN / 4U, &c32[2]);   out->crc32_hw_dma     = DWT->CYCCNT - t0;
+
+    __set_PRIMASK(primask);
+
+    out->match = (c16[0] == c16[1] && c16[0] == c16[2] && ok32 && c32[0] == c32[1] && c32[0] == c32[2]) ? 1U : 0U;
+}
+
+#endif // CRC_BENCH
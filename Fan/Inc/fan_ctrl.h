@@ -0,0 +1,57 @@
+#ifndef FAN_CTRL_H
+#define FAN_CTRL_H
+
+#include "fan_pwm.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 温度驱动的风扇控制
+ * 每个风扇监视若干路NTC（zone_mask，bit0=NTC1，bit1=NTC2），取其中最高温度查曲线：
+ *   - 曲线为若干 (温度, 占空比) 点的分段线性插值，低于第一点关风扇，高于最后一点取最后一点；
+ *   - 回差：温度上升立即跟随，下降要低于上次取值 hyst 以上才跟随（风扇不会在阈值附近反复启停）；
+ *   - 最低转速：非零输出不低于 min_spin（低占空比风扇转不起来或会停转）；
+ *   - 起转脉冲：从停止到转动先以 FAN_CTRL_KICK_PERMILLE 运行 kick_ms，克服静摩擦；
+ *   - 斜率限制：输出每秒最多变化 slew，避免转速突变的噪声和电流冲击；
+ *   - 被监视的NTC短路/断路时直接全速（故障安全）。
+ * 手动模式下上位机给定占空比，最低转速/起转/斜率同样生效。
+ */
+#define FAN_CTRL_PERIOD_MS          100U    // 控制周期
+#define FAN_CTRL_CURVE_MAX          6U      // 曲线最多点数
+#define FAN_CTRL_HYST_CENTI         300     // 默认回差 3℃
+#define FAN_CTRL_MIN_SPIN_PERMILLE  200U    // 默认最低转速占空比
+#define FAN_CTRL_KICK_PERMILLE      1000U   // 起转脉冲占空比
+#define FAN_CTRL_KICK_MS            500U    // 默认起转脉冲时长，0=不起转
+#define FAN_CTRL_SLEW_PERMILLE_S    300U    // 默认斜率（‰/s），0=不限
+#define FAN_CTRL_FAULT_PERMILLE     1000U   // 传感器故障时的占空比
+
+#define FAN_CTRL_ZONE_NTC1          0x01U
+#define FAN_CTRL_ZONE_NTC2          0x02U
+
+typedef struct{
+    int32_t  temp_centi;    // 0.01℃，各点必须严格递增
+    uint16_t permille;      // 0~1000
+}fan_curve_point_t;
+
+typedef enum{
+    FAN_CTRL_AUTO = 0,      // 按温度曲线
+    FAN_CTRL_MANUAL         // 上位机给定
+}fan_ctrl_mode_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void fan_ctrl_init(void);
+uint8_t fan_ctrl_set_curve(fan_id_t fan, const fan_curve_point_t *points, uint8_t num);
+void fan_ctrl_set_zones(fan_id_t fan, uint8_t zone_mask);
+void fan_ctrl_set_hyst(fan_id_t fan, int32_t hyst_centi);
+void fan_ctrl_set_min_spin(fan_id_t fan, uint16_t permille);
+void fan_ctrl_set_kick(fan_id_t fan, uint16_t kick_ms);
+void fan_ctrl_set_slew(fan_id_t fan, uint16_t permille_per_s);
+void fan_ctrl_set_mode(fan_id_t fan, fan_ctrl_mode_t mode);
+void fan_ctrl_set_manual(fan_id_t fan, uint16_t permille);
+fan_ctrl_mode_t fan_ctrl_get_mode(fan_id_t fan);
+uint16_t fan_ctrl_get_target(fan_id_t fan);
+uint16_t fan_ctrl_get_output(fan_id_t fan);
+void fan_ctrl_tick_1ms(void);
+
+#endif // FAN_CTRL_H
@@ -0,0 +1,55 @@
+#ifndef FAN_MON_H
+#define FAN_MON_H
+
+#include "fan_pwm.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 风扇电流监测（FAN1 = PC2/CH12，FAN2 = PC3/CH13）
+ * 在 ADC 帧回调里累加电流，每 2^FAN_MON_WINDOW_SHIFT 帧（约 280ms）取平均，
+ * 与当前指令占空比下的期望电流比较：
+ *   期望 = idle_raw + (full_raw - idle_raw) * 占空比 / 1000
+ *   实测 < 期望*DISCONNECT_PCT        → 断线/未接
+ *   实测 > 期望*BLOCKED_PCT           → 堵转（转子不转，反电势消失，电流升高）
+ *   实测在 [DEGRADED_LO, DEGRADED_HI] 之外 → 性能下降（积灰、轴承磨损）
+ * 占空比变化后等 FAN_MON_SETTLE_WINDOWS 个窗口（转速稳定）再判定，
+ * 占空比低于 FAN_MON_MIN_DUTY 时模型不可靠，不判定。
+ * 连续 FAN_MON_CONFIRM 个窗口同一结论才更新状态。
+ *
+ * 任一风扇堵转/断线时，把加热功率降额到 FAN_MON_DERATE_PERMILLE（heat_pwm_set_power_cap），
+ * 全部恢复正常后解除。
+ *
+ * 注意：带堵转保护的无刷风扇堵转后会间歇重启，平均电流偏低，多判为断线/性能下降，同样会降额。
+ */
+#define FAN_MON_WINDOW_SHIFT        10U     // 窗口 = 1024 帧
+#define FAN_MON_SETTLE_WINDOWS      8U      // 占空比变化后的稳定等待（约 2.2s）
+#define FAN_MON_CONFIRM             3U
+#define FAN_MON_DUTY_CHANGE_PERMILLE 50U    // 占空比变化超过此值才重新等待稳定
+#define FAN_MON_MIN_DUTY            200U    // 判定所需最低占空比（‰）
+#define FAN_MON_FULL_RAW            400U    // 默认：100% 占空比时的电流码值（按风扇型号标定）
+#define FAN_MON_IDLE_RAW            0U      // 默认：0% 占空比时的电流码值
+#define FAN_MON_DISCONNECT_PCT      20U
+#define FAN_MON_BLOCKED_PCT         170U
+#define FAN_MON_DEGRADED_LO_PCT     70U
+#define FAN_MON_DEGRADED_HI_PCT     130U
+#define FAN_MON_DERATE_PERMILLE     300U    // 散热失效时加热功率上限
+
+typedef enum{
+    FAN_MON_UNKNOWN = 0,    // 尚未判定（刚上电/占空比太低/刚变化）
+    FAN_MON_OK,
+    FAN_MON_DEGRADED,
+    FAN_MON_BLOCKED,
+    FAN_MON_DISCONNECTED
+}fan_mon_health_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void fan_mon_init(void);
+void fan_mon_set_model(fan_id_t fan, uint16_t idle_raw, uint16_t full_raw);
+fan_mon_health_t fan_mon_get_health(fan_id_t fan);
+uint16_t fan_mon_get_current_raw(fan_id_t fan);
+uint16_t fan_mon_get_expected_raw(fan_id_t fan);
+uint8_t fan_mon_is_derating(void);
+
+#endif // FAN_MON_H
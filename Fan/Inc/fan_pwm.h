@@ -0,0 +1,30 @@
+#ifndef FAN_PWM_H
+#define FAN_PWM_H
+
+#include "stm32f103xe.h"
+#include "hardware_config.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 风扇 PWM：TIM3 CH1(PA6)=FAN1，CH2(PA7)=FAN2
+ * 25kHz 在人耳范围之外，4线风扇规范也要求 21~28kHz。
+ * TIM3 在 APB1（36MHz，定时器时钟倍频到 72MHz），PSC=0，ARR=2879，
+ * 一个周期 2880 个计数，比千分比更细，千分比换算到 CCR 不丢精度。
+ *
+ * CCR 开启预装载：新占空比写入影子寄存器，在下一个更新事件（周期边界）才生效，
+ * 不会出现半个周期的毛刺脉冲。
+ */
+#define FAN_PWM_TIM_CLK_HZ      SYSTEM_CLOCK_FREQ
+#define FAN_PWM_ARR             (FAN_PWM_TIM_CLK_HZ / FAN_PWM_FREQUENCY - 1U)   // 2879
+#define FAN_PWM_PERMILLE_MAX    FAN_PWM_RESOLUTION
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void fan_pwm_init(void);
+void fan_pwm_set_permille(fan_id_t fan, uint16_t permille);
+uint16_t fan_pwm_get_permille(fan_id_t fan);
+const uint16_t *fan_pwm_permille_table(void);
+void fan_pwm_stop_all(void);
+
+#endif // FAN_PWM_H
@@ -0,0 +1,317 @@
+#include "fan_ctrl.h"
+#include "fan_mon.h"
+#include "temp_sense.h"
+
+/***************************************************************
+ * 内部类型
+ ***************************************************************/
+
+typedef struct{
+    fan_ctrl_mode_t   mode;
+    fan_curve_point_t curve[FAN_CTRL_CURVE_MAX];
+    uint8_t  curve_num;
+    uint8_t  zone_mask;
+    int32_t  hyst;          // 0.01℃
+    uint16_t min_spin;      // ‰
+    uint16_t kick_ms;
+    uint16_t slew;          // ‰/s
+    uint16_t slew_rem;      // 斜率步长的小数部分累计（‰/1000），低斜率下也能逐步移动
+    uint16_t manual;        // 手动给定（‰）
+
+    int32_t  t_eff;         // 回差后的曲线输入温度
+    uint8_t  has_t;
+    uint16_t target;        // 曲线/手动给定经最低转速处理后的目标
+    uint16_t output;        // 实际输出
+    uint16_t kick_left_ms;
+}fan_ctrl_t;
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static fan_ctrl_t s_fan[FAN_NUM];
+static uint16_t s_tick_ms = 0;
+static volatile uint8_t s_inited = 0;
+
+/**
+ * @brief 默认曲线：40℃ 以下停，40~80℃ 由 30% 线性升到 100%
+ */
+static const fan_curve_point_t s_default_curve[] = {
+    {4000,  300},
+    {6000,  600},
+    {8000, 1000},
+};
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+/**
+ * @brief 分段线性插值
+ */
+static uint16_t fan_ctrl_curve_eval(const fan_ctrl_t *f, int32_t t)
+{
+    const fan_curve_point_t *c = f->curve;
+    uint8_t n = f->curve_num;
+
+    if(n == 0 || t < c[0].temp_centi) return 0;
+    if(t >= c[n - 1U].temp_centi) return c[n - 1U].permille;
+
+    for(uint8_t i = 1; i < n; i++)
+    {
+        if(t < c[i].temp_centi)
+        {
+            int32_t dt = c[i].temp_centi - c[i - 1U].temp_centi;
+            int32_t dp = (int32_t)c[i].permille - (int32_t)c[i - 1U].permille;
+            return (uint16_t)((int32_t)c[i - 1U].permille + dp * (t - c[i - 1U].temp_centi) / dt);
+        }
+    }
+    return c[n - 1U].permille;
+}
+
+/**
+ * @brief 取被监视NTC的最高温度
+ * @return 1=有温度，0=尚无数据；*fault 置1表示有传感器短路/断路/数据过期
+ */
+static uint8_t fan_ctrl_read_temp(uint8_t zone_mask, int32_t *t_max, uint8_t *fault)
+{
+    uint8_t have = 0;
+
+    *fault = 0;
+    for(int i = 0; i < TEMP_SENSE_CH_NUM; i++)
+    {
+        temp_sense_reading_t r;
+
+        if(!(zone_mask & (1U << i))) continue;
+        if(!temp_sense_read((temp_sense_ch_t)i, &r))
+        {
+            if(r.status != TEMP_SENSE_INIT) *fault = 1;
+            continue;
+        }
+        if(!have || r.temp_centi > *t_max) *t_max = r.temp_centi;
+        have = 1;
+    }
+    return have;
+}
+
+/**
+ * @brief 温度 -> 曲线占空比（含回差）
+ */
+static uint16_t fan_ctrl_auto_target(fan_ctrl_t *f)
+{
+    int32_t t = 0;
+    uint8_t fault;
+
+    if(!fan_ctrl_read_temp(f->zone_mask, &t, &fault))
+    {
+        return fault ? FAN_CTRL_FAULT_PERMILLE : 0;
+    }
+    if(fault) return FAN_CTRL_FAULT_PERMILLE;
+
+    // 上升立即跟随，下降超过回差才跟随（保持比实际温度高 hyst）
+    if(!f->has_t || t > f->t_eff)   f->t_eff = t;
+    else if(t < f->t_eff - f->hyst) f->t_eff = t + f->hyst;
+    f->has_t = 1;
+
+    return fan_ctrl_curve_eval(f, f->t_eff);
+}
+
+/**
+ * @brief 目标 -> 输出：起转脉冲、斜率限制、最低转速
+ */
+static void fan_ctrl_step(fan_ctrl_t *f, uint16_t target)
+{
+    uint32_t acc = (uint32_t)f->slew * FAN_CTRL_PERIOD_MS + f->slew_rem;
+    uint16_t step = (uint16_t)(acc / 1000U);
+    uint16_t out = f->output;
+
+    f->slew_rem = (uint16_t)(acc % 1000U);
+
+    if(target > 0 && target < f->min_spin) target = f->min_spin;
+    f->target = target;
+
+    if(target == 0)
+    {
+        // 降到最低转速以下没有意义，直接停
+        f->kick_left_ms = 0;
+        if(f->slew == 0 || out <= f->min_spin || out <= step) out = 0;
+        else out -= step;
+        f->output = out;
+        return;
+    }
+
+    if(out == 0)
+    {
+        if(f->kick_ms)
+        {
+            f->kick_left_ms = f->kick_ms;
+            f->output = FAN_CTRL_KICK_PERMILLE;
+            return;
+        }
+        out = f->min_spin;      // 从最低转速开始爬
+    }
+
+    if(f->kick_left_ms)
+    {
+        f->kick_left_ms = (f->kick_left_ms > FAN_CTRL_PERIOD_MS) ? (uint16_t)(f->kick_left_ms - FAN_CTRL_PERIOD_MS) : 0;
+        if(f->kick_left_ms) return;
+        out = (target < FAN_CTRL_KICK_PERMILLE) ? target : FAN_CTRL_KICK_PERMILLE;  // 脉冲结束直接落到目标
+    }
+
+    if(f->slew == 0)              out = target;
+    else if(out + step < target)  out += step;
+    else if(out > target + step)  out -= step;
+    else                          out = target;
+
+    if(out < f->min_spin) out = f->min_spin;
+    f->output = out;
+}
+
+static void fan_ctrl_run(void)
+{
+    for(int i = 0; i < FAN_NUM; i++)
+    {
+        fan_ctrl_t *f = &s_fan[i];
+        uint16_t target;
+
+        if(f->mode == FAN_CTRL_MANUAL) target = f->manual;
+        else                           target = fan_ctrl_auto_target(f);
+
+        fan_ctrl_step(f, target);
+        fan_pwm_set_permille((fan_id_t)i, f->output);
+    }
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化风扇控制：自动模式、默认曲线，两台风扇都看两路NTC
+ * @note  会初始化 fan_pwm、fan_mon 和 temp_sense
+ */
+void fan_ctrl_init(void)
+{
+    s_inited = 0;
+    fan_pwm_init();
+    fan_mon_init();
+    temp_sense_init();
+
+    for(int i = 0; i < FAN_NUM; i++)
+    {
+        fan_ctrl_t *f = &s_fan[i];
+
+        *f = (fan_ctrl_t){0};
+        f->mode = FAN_CTRL_AUTO;
+        for(uint8_t k = 0; k < sizeof(s_default_curve) / sizeof(s_default_curve[0]); k++)
+        {
+            f->curve[k] = s_default_curve[k];
+        }
+        f->curve_num = (uint8_t)(sizeof(s_default_curve) / sizeof(s_default_curve[0]));
+        f->zone_mask = FAN_CTRL_ZONE_NTC1 | FAN_CTRL_ZONE_NTC2;
+        f->hyst = FAN_CTRL_HYST_CENTI;
+        f->min_spin = FAN_CTRL_MIN_SPIN_PERMILLE;
+        f->kick_ms = FAN_CTRL_KICK_MS;
+        f->slew = FAN_CTRL_SLEW_PERMILLE_S;
+    }
+    s_tick_ms = 0;
+    s_inited = 1;
+}
+
+/**
+ * @brief 设置温度曲线
+ * @param points 温度严格递增，占空比 0~1000
+ * @return 1=成功，0=点数或取值非法（原曲线不变）
+ */
+uint8_t fan_ctrl_set_curve(fan_id_t fan, const fan_curve_point_t *points, uint8_t num)
+{
+    if(fan >= FAN_NUM || points == 0 || num == 0 || num > FAN_CTRL_CURVE_MAX) return 0;
+    for(uint8_t i = 0; i < num; i++)
+    {
+        if(points[i].permille > FAN_PWM_PERMILLE_MAX) return 0;
+        if(i && points[i].temp_centi <= points[i - 1U].temp_centi) return 0;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for(uint8_t i = 0; i < num; i++) s_fan[fan].curve[i] = points[i];
+    s_fan[fan].curve_num = num;
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+void fan_ctrl_set_zones(fan_id_t fan, uint8_t zone_mask)
+{
+    if(fan >= FAN_NUM) return;
+    s_fan[fan].zone_mask = zone_mask & (FAN_CTRL_ZONE_NTC1 | FAN_CTRL_ZONE_NTC2);
+}
+
+void fan_ctrl_set_hyst(fan_id_t fan, int32_t hyst_centi)
+{
+    if(fan >= FAN_NUM || hyst_centi < 0) return;
+    s_fan[fan].hyst = hyst_centi;
+}
+
+void fan_ctrl_set_min_spin(fan_id_t fan, uint16_t permille)
+{
+    if(fan >= FAN_NUM) return;
+    if(permille > FAN_PWM_PERMILLE_MAX) permille = FAN_PWM_PERMILLE_MAX;
+    s_fan[fan].min_spin = permille;
+}
+
+void fan_ctrl_set_kick(fan_id_t fan, uint16_t kick_ms)
+{
+    if(fan >= FAN_NUM) return;
+    s_fan[fan].kick_ms = kick_ms;
+}
+
+void fan_ctrl_set_slew(fan_id_t fan, uint16_t permille_per_s)
+{
+    if(fan >= FAN_NUM) return;
+    s_fan[fan].slew = permille_per_s;
+}
+
+void fan_ctrl_set_mode(fan_id_t fan, fan_ctrl_mode_t mode)
+{
+    if(fan >= FAN_NUM) return;
+    s_fan[fan].mode = mode;
+}
+
+/**
+ * @brief 手动模式下的占空比给定（自动模式下保存，切到手动后生效）
+ */
+void fan_ctrl_set_manual(fan_id_t fan, uint16_t permille)
+{
+    if(fan >= FAN_NUM) return;
+    if(permille > FAN_PWM_PERMILLE_MAX) permille = FAN_PWM_PERMILLE_MAX;
+    s_fan[fan].manual = permille;
+}
+
+fan_ctrl_mode_t fan_ctrl_get_mode(fan_id_t fan)
+{
+    if(fan >= FAN_NUM) return FAN_CTRL_AUTO;
+    return s_fan[fan].mode;
+}
+
+uint16_t fan_ctrl_get_target(fan_id_t fan)
+{
+    if(fan >= FAN_NUM) return 0;
+    return s_fan[fan].target;
+}
+
+uint16_t fan_ctrl_get_output(fan_id_t fan)
+{
+    if(fan >= FAN_NUM) return 0;
+    return s_fan[fan].output;
+}
+
+/**
+ * @brief 1ms 节拍，在 SysTick 中调用，每 FAN_CTRL_PERIOD_MS 运行一次
+ */
+void fan_ctrl_tick_1ms(void)
+{
+    if(!s_inited) return;
+    if(++s_tick_ms < FAN_CTRL_PERIOD_MS) return;
+    s_tick_ms = 0;
+    fan_ctrl_run();
+}
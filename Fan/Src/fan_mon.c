@@ -0,0 +1,198 @@
+#include "fan_mon.h"
+#include "adc_frame.h"
+#include "heat_pwm.h"
+
+/***************************************************************
+ * 内部类型
+ ***************************************************************/
+
+typedef struct{
+    uint8_t  adc_ch;        // 帧内通道序号
+    uint16_t idle_raw;
+    uint16_t full_raw;
+
+    uint32_t sum;           // 当前窗口累加
+    uint16_t duty_start;    // 窗口开始时的指令占空比
+    uint8_t  settle;        // 剩余稳定等待窗口数
+    uint8_t  pending;       // 正在确认的结论
+    uint8_t  confirm;
+    uint8_t  health;        // fan_mon_health_t
+    uint16_t meas;          // 上一窗口平均电流
+    uint16_t expect;        // 上一窗口期望电流
+}fan_mon_t;
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static fan_mon_t s_mon[FAN_NUM];
+static uint16_t s_frame_cnt = 0;
+static volatile uint8_t s_derating = 0;
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint16_t fan_mon_expected(const fan_mon_t *m, uint16_t duty)
+{
+    int32_t span = (int32_t)m->full_raw - (int32_t)m->idle_raw;
+    return (uint16_t)((int32_t)m->idle_raw + span * duty / (int32_t)FAN_PWM_PERMILLE_MAX);
+}
+
+/**
+ * @brief 按实测/期望比例分类（乘法比较，不做除法）
+ */
+static uint8_t fan_mon_classify(uint32_t meas, uint32_t expect)
+{
+    uint32_t m100 = meas * 100U;
+
+    if(m100 < expect * FAN_MON_DISCONNECT_PCT) return FAN_MON_DISCONNECTED;
+    if(m100 > expect * FAN_MON_BLOCKED_PCT)    return FAN_MON_BLOCKED;
+    if(m100 < expect * FAN_MON_DEGRADED_LO_PCT || m100 > expect * FAN_MON_DEGRADED_HI_PCT) return FAN_MON_DEGRADED;
+    return FAN_MON_OK;
+}
+
+/**
+ * @brief 窗口结算：稳定等待、分类、连续确认
+ */
+static void fan_mon_close_window(fan_mon_t *m, uint16_t duty)
+{
+    uint16_t diff = (duty > m->duty_start) ? (uint16_t)(duty - m->duty_start) : (uint16_t)(m->duty_start - duty);
+
+    m->meas = (uint16_t)(m->sum >> FAN_MON_WINDOW_SHIFT);
+    m->expect = fan_mon_expected(m, duty);
+    m->sum = 0;
+    m->duty_start = duty;
+
+    if(diff > FAN_MON_DUTY_CHANGE_PERMILLE)
+    {
+        m->settle = FAN_MON_SETTLE_WINDOWS;
+        m->confirm = 0;
+        return;
+    }
+    if(m->settle) { m->settle--; return; }
+
+    if(duty < FAN_MON_MIN_DUTY || m->expect == 0)
+    {
+        // 停转/低速：保持上次结论，低速本就是正常工况，不因此清除故障
+        m->confirm = 0;
+        return;
+    }
+
+    uint8_t h = fan_mon_classify(m->meas, m->expect);
+    if(h != m->pending)
+    {
+        m->pending = h;
+        m->confirm = 0;
+    }
+    if(m->confirm < FAN_MON_CONFIRM && ++m->confirm >= FAN_MON_CONFIRM)
+    {
+        m->health = h;
+    }
+}
+
+/**
+ * @brief 散热失效降额：任一风扇堵转/断线则限功率，全部恢复后解除
+ */
+static void fan_mon_update_derate(void)
+{
+    uint8_t fail = 0;
+
+    for(int i = 0; i < FAN_NUM; i++)
+    {
+        if(s_mon[i].health == FAN_MON_BLOCKED || s_mon[i].health == FAN_MON_DISCONNECTED) fail = 1;
+    }
+    if(fail != s_derating)
+    {
+        s_derating = fail;
+        heat_pwm_set_power_cap(fail ? FAN_MON_DERATE_PERMILLE : HEAT_PWM_PERMILLE_MAX);
+    }
+}
+
+/**
+ * @brief ADC帧回调：每帧两次加法，窗口结束时结算
+ */
+static void fan_mon_on_adc_frame(const uint16_t *frame)
+{
+    for(int i = 0; i < FAN_NUM; i++) s_mon[i].sum += frame[s_mon[i].adc_ch];
+
+    if(++s_frame_cnt < (1U << FAN_MON_WINDOW_SHIFT)) return;
+    s_frame_cnt = 0;
+
+    for(int i = 0; i < FAN_NUM; i++)
+    {
+        fan_mon_close_window(&s_mon[i], fan_pwm_get_permille((fan_id_t)i));
+    }
+    fan_mon_update_derate();
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化风扇电流监测并挂到ADC帧流上
+ */
+void fan_mon_init(void)
+{
+    for(int i = 0; i < FAN_NUM; i++)
+    {
+        s_mon[i] = (fan_mon_t){0};
+        s_mon[i].idle_raw = FAN_MON_IDLE_RAW;
+        s_mon[i].full_raw = FAN_MON_FULL_RAW;
+        s_mon[i].settle = FAN_MON_SETTLE_WINDOWS;
+        s_mon[i].health = FAN_MON_UNKNOWN;
+        s_mon[i].pending = FAN_MON_UNKNOWN;
+    }
+    s_mon[FAN1].adc_ch = ADC_FRAME_FAN1_CURRENT;
+    s_mon[FAN2].adc_ch = ADC_FRAME_FAN2_CURRENT;
+    s_frame_cnt = 0;
+    s_derating = 0;
+
+    adc_frame_init();
+    adc_frame_register_hook(fan_mon_on_adc_frame);
+}
+
+/**
+ * @brief 设置电流模型（按风扇型号标定：分别在 0% 和 100% 占空比稳定运行后读 fan_mon_get_current_raw）
+ * @note  模型改变后重新等待稳定、状态回到未知
+ */
+void fan_mon_set_model(fan_id_t fan, uint16_t idle_raw, uint16_t full_raw)
+{
+    if(fan >= FAN_NUM || full_raw <= idle_raw) return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s_mon[fan].idle_raw = idle_raw;
+    s_mon[fan].full_raw = full_raw;
+    s_mon[fan].settle = FAN_MON_SETTLE_WINDOWS;
+    s_mon[fan].confirm = 0;
+    s_mon[fan].health = FAN_MON_UNKNOWN;
+    __set_PRIMASK(primask);
+}
+
+fan_mon_health_t fan_mon_get_health(fan_id_t fan)
+{
+    if(fan >= FAN_NUM) return FAN_MON_UNKNOWN;
+    return (fan_mon_health_t)s_mon[fan].health;
+}
+
+/**
+ * @brief 上一窗口平均电流（补偿后的ADC码值）
+ */
+uint16_t fan_mon_get_current_raw(fan_id_t fan)
+{
+    if(fan >= FAN_NUM) return 0;
+    return s_mon[fan].meas;
+}
+
+uint16_t fan_mon_get_expected_raw(fan_id_t fan)
+{
+    if(fan >= FAN_NUM) return 0;
+    return s_mon[fan].expect;
+}
+
+uint8_t fan_mon_is_derating(void)
+{
+    return s_derating;
+}
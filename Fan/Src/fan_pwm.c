@@ -0,0 +1,115 @@
+#include "fan_pwm.h"
+#include "pin_cfg.h"
+
+/***************************************************************
+ * 关键配置区
+ ***************************************************************/
+
+/**
+ * @brief 风扇 PWM 引脚清单：F(端口, 引脚, 目标端口, a, b)
+ */
+#define FAN_PWM_PINS(F, gpio, a, b) ( \
+    F(FAN1_PWM_PORT, FAN1_PWM_PIN, gpio, a, b) | F(FAN2_PWM_PORT, FAN2_PWM_PIN, gpio, a, b) )
+
+/**
+ * @brief 复用推挽 2MHz：25kHz 方波不需要快边沿，慢边沿辐射小
+ */
+static const pin_cfg_port_t s_fan_pin_cfg[] = {
+    PIN_CFG_PORT(FAN_PWM_PINS, GPIOA, PIN_CFG_AF_PP_2M, 0U),
+};
+
+/**
+ * @brief 通道极性：有效电平为低时置 CCxP，CCR 仍表示“通电”时间
+ */
+#if FAN_PWM_ACTIVE_HIGH
+    #define FAN_PWM_CCER_POL    0U
+#else
+    #define FAN_PWM_CCER_POL    (TIM_CCER_CC1P | TIM_CCER_CC2P)
+#endif
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static uint16_t s_fan_permille[FAN_NUM];
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static volatile uint32_t *fan_pwm_ccr(fan_id_t fan)
+{
+    return (fan == FAN1) ? &TIM3->CCR1 : &TIM3->CCR2;
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化 TIM3 两路 25kHz PWM，占空比为 0
+ * @note  先把定时器配好并跑起来（输出为无效电平），再把 PA6/PA7 切到复用功能，
+ *        切换瞬间不会出现脉冲
+ */
+void fan_pwm_init(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+    (void)RCC->APB1ENR;
+
+    TIM3->CR1 = 0;
+    TIM3->PSC = 0;
+    TIM3->ARR = FAN_PWM_ARR;
+    TIM3->CCR1 = 0;
+    TIM3->CCR2 = 0;
+
+    // CH1/CH2：PWM 模式1（CNT < CCR 为有效电平）+ CCR 预装载
+    TIM3->CCMR1 = (6U << TIM_CCMR1_OC1M_Pos) | TIM_CCMR1_OC1PE
+                | (6U << TIM_CCMR1_OC2M_Pos) | TIM_CCMR1_OC2PE;
+    TIM3->CCER = TIM_CCER_CC1E | TIM_CCER_CC2E | FAN_PWM_CCER_POL;
+
+    // ARR 预装载 + 边沿对齐向上计数；UG 把 PSC/ARR/CCR 装进影子寄存器
+    TIM3->CR1 = TIM_CR1_ARPE;
+    TIM3->EGR = TIM_EGR_UG;
+    TIM3->SR = 0;
+    TIM3->CR1 |= TIM_CR1_CEN;
+
+    pin_cfg_apply(s_fan_pin_cfg, (uint8_t)(sizeof(s_fan_pin_cfg) / sizeof(s_fan_pin_cfg[0])),
+                  FAN_PWM_PINS(PIN_CFG_CLK_OF, 0, 0, 0));
+
+    for(int i = 0; i < FAN_NUM; i++) s_fan_permille[i] = 0;
+}
+
+/**
+ * @brief 设置风扇占空比
+ * @param fan      FAN1/FAN2
+ * @param permille 0~1000（千分比），超出按 1000
+ * @note  写的是影子寄存器，下一个 PWM 周期开始时生效；单次 32 位写，可在中断里调用
+ */
+void fan_pwm_set_permille(fan_id_t fan, uint16_t permille)
+{
+    if(fan >= FAN_NUM) return;
+    if(permille > FAN_PWM_PERMILLE_MAX) permille = FAN_PWM_PERMILLE_MAX;
+
+    s_fan_permille[fan] = permille;
+    // 1000‰ 时 CCR = ARR+1，整周期有效电平
+    *fan_pwm_ccr(fan) = ((uint32_t)permille * (FAN_PWM_ARR + 1U) + FAN_PWM_PERMILLE_MAX / 2U) / FAN_PWM_PERMILLE_MAX;
+}
+
+uint16_t fan_pwm_get_permille(fan_id_t fan)
+{
+    if(fan >= FAN_NUM) return 0;
+    return s_fan_permille[fan];
+}
+
+/**
+ * @brief 当前输出占空比数组的只读视图（FAN_NUM 个，供寄存器映射零拷贝读取）
+ */
+const uint16_t *fan_pwm_permille_table(void)
+{
+    return s_fan_permille;
+}
+
+void fan_pwm_stop_all(void)
+{
+    for(int i = 0; i < FAN_NUM; i++) fan_pwm_set_permille((fan_id_t)i, 0);
+}
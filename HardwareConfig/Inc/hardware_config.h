@@ -47,9 +47,19 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
 #define USE_RS485_COMM
 // #define USE_CAN_COMM
 
+#if defined(USE_RS485_COMM) && defined(USE_CAN_COMM)
+    #error "USE_RS485_COMM 与 USE_CAN_COMM 只能定义一个"
+#endif
+
 #ifdef USE_CAN_COMM
     #define COMM_CAN            CAN1
-    // CAN需要remap到PB8/PB9
+    // CAN remap 到 PB8/PB9（PA11/PA12 已给电机5/6反转），热控1/2 随之移到 PB6/PB7
+    #define CAN_RX_PIN          GPIO_PIN_8    // PB8
+    #define CAN_RX_PORT         GPIOB
+    #define CAN_TX_PIN          GPIO_PIN_9    // PB9
+    #define CAN_TX_PORT         GPIOB
+    #define CAN_BITRATE_DEFAULT 500000U
+    #define CAN_NODE_ID_DEFAULT 1U
 #endif
 
 #ifdef USE_RS485_COMM
@@ -60,6 +70,7 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
     #define RS485_RX_PORT       GPIOA
     #define RS485_DE_PIN        GPIO_PIN_8    // PA8
     #define RS485_DE_PORT       GPIOA
+    #define RS485_BAUD_DEFAULT  115200U
 #endif
 
 
@@ -70,6 +81,7 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
  *  CH8~CH9  : NTC温度   PB0~PB1   (2路)
  *  CH10~CH11: 热控电流  PC0~PC1   (2路)
  *  CH12~CH13: 风扇电流  PC2~PC3   (2路)
+ *  CH17     : 内部 Vrefint（测 VDDA，补偿电流通道）
  * ================================================================ */
 
 
@@ -185,6 +197,7 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
 #define HALL_EN_CLK_ENABLE() __HAL_RCC_GPIOD_CLK_ENABLE()
 
 #define HALL_EN_ACTIVE_LEVEL GPIO_PIN_SET  // 高有效；低有效就改 RESET
+#define HALL_EN_SETTLE_MS    5U            // 霍尔上电到输出稳定的时间，期间的边沿不计数
 
 
 /* ================================================================
@@ -214,6 +227,7 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
 /* PWM参数 */
 #define FAN_PWM_FREQUENCY       25000U
 #define FAN_PWM_RESOLUTION      1000U
+#define FAN_PWM_ACTIVE_HIGH     1       // 1=PWM 高电平期间风扇通电；驱动管反相时改 0
 
 
 /* ================================================================
@@ -221,15 +235,24 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
  * ================================================================
  * 热控IO分配:
  *   PB8-PB11 (4路) + PC9 (1路) + PA13-PA14 (2路) + PD2 (1路) = 8路
+ *   使用 CAN 时 PB8/PB9 让给 CAN，热控1/2 改到 PB6/PB7（原预留脚）
  * 注：PA13/PA14 为 SWD 脚，除非 IO 不够，否则后续建议挪走
  * ================================================================ */
 
 /* ---------------- 热控输出 IO (8路) ---------------- */
+#ifdef USE_CAN_COMM
+#define HEAT_CTRL1_PIN          GPIO_PIN_6    // PB6（PB8 给 CAN_RX）
+#else
 #define HEAT_CTRL1_PIN          GPIO_PIN_8
+#endif
 #define HEAT_CTRL1_PORT         GPIOB
 #define HEAT_CTRL1_CLK_ENABLE() __HAL_RCC_GPIOB_CLK_ENABLE()
 
+#ifdef USE_CAN_COMM
+#define HEAT_CTRL2_PIN          GPIO_PIN_7    // PB7（PB9 给 CAN_TX）
+#else
 #define HEAT_CTRL2_PIN          GPIO_PIN_9
+#endif
 #define HEAT_CTRL2_PORT         GPIOB
 #define HEAT_CTRL2_CLK_ENABLE() __HAL_RCC_GPIOB_CLK_ENABLE()
 
@@ -267,6 +290,10 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
 #define NTC2_ADC_PIN            GPIO_PIN_1
 #define NTC2_ADC_PORT           GPIOB
 
+/* NTC 分压上端接 VDDA（与 ADC 参考同源）时读数是比例式的，与供电无关，不做补偿；
+ * 若改成从独立电源供电，置0，NTC 通道将和电流通道一样按 Vrefint 补偿 */
+#define NTC_DIVIDER_RATIOMETRIC 1
+
 
 /* ---------------- 热控供电电流 ADC (2路) ---------------- */
 #define HEAT_CURRENT1_ADC_CHANNEL   ADC_CHANNEL_10  // PC0
@@ -277,13 +304,21 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
 #define HEAT_CURRENT2_ADC_PIN       GPIO_PIN_1
 #define HEAT_CURRENT2_ADC_PORT      GPIOC
 
+/* 每路电流采样覆盖的热控通道（bit i = HEAT_CTRLi+1）：电流1 = 热控1~4，电流2 = 热控5~8 */
+#define HEAT_CURRENT1_CH_MASK       0x0FU
+#define HEAT_CURRENT2_CH_MASK       0xF0U
+
 
 /* ================================================================
  *                      系统配置
  * ================================================================ */
 #define SYSTEM_CLOCK_FREQ       72000000U
-#define ADC_VREF                3.3f
+#define ADC_VREF_MV             3300U   // 标称 VDDA，电流类通道的码值都换算到此参考下
 #define ADC_RESOLUTION          4096U
+#define ADC_VREFINT_CHANNEL     ADC_CHANNEL_VREFINT
+#define ADC_VREFINT_MV          1200U   // Vrefint 默认值（典型值；F103 无出厂校准值，逐板标定见 adc_frame_calibrate_vrefint）
+#define ADC_VREFINT_MV_MIN      1160U   // 数据手册范围
+#define ADC_VREFINT_MV_MAX      1240U
 
 
 /* ================================================================
@@ -291,7 +326,7 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
  * ================================================================
  * PA0-PA5:   电机电流ADC (6路) ✓
  * PA6-PA7:   风扇PWM (2路) ✓
- * PA8-PA10:  RS485通信 (3路) ✓
+ * PA8-PA10:  RS485通信 (3路) ✓（使用 CAN 时空闲）
  * PA11-PA12: 电机5/6反转 (2路) ✓
  * PA13-PA14: 热控6-7 (2路) ⚠️ 需禁SWD
  * PA15:      电机1霍尔输入 (1路) ✓
@@ -300,6 +335,7 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
  * PB8-PB11:  热控1-4 (4路) ✓
  * PB12-PB15: 电机1-4正转 (4路) ✓
  * PB2-PB7:   预留GPIO（原霍尔输出位）✓
+ *   CAN 版:  PB8/PB9 = CAN_RX/CAN_TX，PB6/PB7 = 热控1-2
  *
  * PC0-PC1:   热控电流ADC (2路) ✓
  * PC2-PC3:   风扇电流ADC (2路) ✓
@@ -314,7 +350,7 @@ typedef enum { HEAT1=0, HEAT2, HEAT3, HEAT4, HEAT5, HEAT6, HEAT7, HEAT8 } heat_i
  *   1. PB3/PB4 若后续使用，需在CubeMX中禁用JTAG，保留SWD
  *   2. PA13/PA14 若用作GPIO，需要禁SWD（下载后无法再调试）
  *   3. PD0/PD1 若使用外部HSE晶振则不可用作GPIO
- *   4. 如使用CAN，需remap到PB8/PB9（会占用热控1-2）
+ *   4. 如使用CAN，remap到PB8/PB9，热控1-2 自动移到 PB6/PB7（硬件需对应走线）
  * ================================================================ */
 
 #endif /* __HARDWARE_CONFIG_H__ */
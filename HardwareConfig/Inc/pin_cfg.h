@@ -0,0 +1,86 @@
+#ifndef __PIN_CFG_H__
+#define __PIN_CFG_H__
+
+#include "stm32f103xe.h"
+#include <stdint.h>
+
+/* ================================================================
+ *              编译期引脚配置表
+ * ================================================================
+ * STM32F103 每个引脚在 CRL(0~7脚)/CRH(8~15脚) 里占 4bit（MODE[1:0]+CNF[1:0]）。
+ * 驱动把自己用到的引脚（hardware_config.h 里的 PORT/PIN 宏）代入下面的宏，
+ * 编译器直接算出每个端口 CRL/CRH 的 掩码/取值、安全电平和时钟使能位，
+ * 初始化时每个寄存器只写一次，不再逐脚循环、逐口比较。
+ *
+ * 用法：驱动定义引脚清单宏 LIST(F, gpio, a, b)，把每个 F(PORT, PIN, gpio, a, b) 用 | 连起来，
+ * 再用 PIN_CFG_PORT(LIST, GPIOx, 配置值, 安全电平) 为每个端口生成一项，见 heat_out_drv.c。
+ * ================================================================ */
+
+/* 4bit 配置值（CNF<<2 | MODE） */
+#define PIN_CFG_ANALOG          0x0U    // 模拟输入
+#define PIN_CFG_IN_FLOATING     0x4U    // 浮空输入
+#define PIN_CFG_IN_PULL         0x8U    // 上/下拉输入（ODR 决定方向）
+#define PIN_CFG_OUT_PP_2M       0x2U    // 推挽输出 2MHz
+#define PIN_CFG_OUT_PP_50M      0x3U    // 推挽输出 50MHz
+#define PIN_CFG_AF_PP_2M        0xAU    // 复用推挽输出 2MHz
+#define PIN_CFG_AF_PP_50M       0xBU    // 复用推挽输出 50MHz
+
+/**
+ * @brief 单bit引脚掩码 -> 引脚号（0~15），常量表达式
+ */
+#define PIN_POS(pin) \
+    ((pin) == 0x0001U ? 0U  : (pin) == 0x0002U ? 1U  : (pin) == 0x0004U ? 2U  : (pin) == 0x0008U ? 3U  : \
+     (pin) == 0x0010U ? 4U  : (pin) == 0x0020U ? 5U  : (pin) == 0x0040U ? 6U  : (pin) == 0x0080U ? 7U  : \
+     (pin) == 0x0100U ? 8U  : (pin) == 0x0200U ? 9U  : (pin) == 0x0400U ? 10U : (pin) == 0x0800U ? 11U : \
+     (pin) == 0x1000U ? 12U : (pin) == 0x2000U ? 13U : (pin) == 0x4000U ? 14U : 15U)
+
+/**
+ * @brief 引脚在 want_port 的 CRL(hi=0)/CRH(hi=1) 中的 4bit 字段，填入 cfg；不属于该口/该寄存器为 0
+ */
+#define PIN_CFG_CR_FIELD(port, pin, want_port, hi, cfg) \
+    ((((port) == (want_port)) && ((PIN_POS(pin) >= 8U) == (hi))) \
+        ? ((uint32_t)(cfg) << ((PIN_POS(pin) & 7U) * 4U)) : 0U)
+
+/**
+ * @brief 引脚属于 want_port 时取其引脚位，否则为 0（后两个参数占位，便于和 CR_FIELD 共用清单）
+ */
+#define PIN_CFG_PIN_OF(port, pin, want_port, a, b) \
+    (((port) == (want_port)) ? (uint32_t)(pin) : 0U)
+
+/**
+ * @brief 端口对应的 APB2 时钟使能位（want_port/a/b 占位）
+ */
+#define PIN_CFG_CLK_OF(port, pin, want_port, a, b) \
+    ((port) == GPIOA ? RCC_APB2ENR_IOPAEN : (port) == GPIOB ? RCC_APB2ENR_IOPBEN : \
+     (port) == GPIOC ? RCC_APB2ENR_IOPCEN : (port) == GPIOD ? RCC_APB2ENR_IOPDEN : 0U)
+
+/**
+ * @brief 单个端口的配置
+ */
+typedef struct {
+    GPIO_TypeDef *port;
+    uint32_t crl_mask;
+    uint32_t crl_val;
+    uint32_t crh_mask;
+    uint32_t crh_val;
+    uint32_t safe_bsrr;     // 切换模式前先写入的电平（BSRR格式），保证一上电就是安全态
+}pin_cfg_port_t;
+
+/**
+ * @brief 由引脚清单生成一个端口的配置项
+ * @param LIST  引脚清单宏，形如 LIST(F, gpio, a, b)
+ * @param cfg   4bit 配置值
+ * @param safe  safe_bsrr 表达式（通常为 LIST(PIN_CFG_PIN_OF, gpio, 0, 0) << 16）
+ */
+#define PIN_CFG_PORT(LIST, gpio, cfg, safe) \
+    { (gpio), \
+      LIST(PIN_CFG_CR_FIELD, gpio, 0, 0xFU), LIST(PIN_CFG_CR_FIELD, gpio, 0, cfg), \
+      LIST(PIN_CFG_CR_FIELD, gpio, 1, 0xFU), LIST(PIN_CFG_CR_FIELD, gpio, 1, cfg), \
+      (safe) }
+
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void pin_cfg_apply(const pin_cfg_port_t *tbl, uint8_t num, uint32_t apb2_clk);
+
+#endif /* __PIN_CFG_H__ */
@@ -0,0 +1,25 @@
+#include "pin_cfg.h"
+
+/**
+ * @brief 按编译期生成的表配置一组端口
+ * @param tbl      端口配置表（掩码全 0 的端口跳过）
+ * @param num      表项数
+ * @param apb2_clk 需要打开的 APB2 时钟位（GPIO口/AFIO），一次写入
+ * @note  每个端口：先写 BSRR 定好输出电平，再各写一次 CRL/CRH，
+ *        引脚切到输出模式的那一刻就是安全电平，不会有毛刺。
+ */
+void pin_cfg_apply(const pin_cfg_port_t *tbl, uint8_t num, uint32_t apb2_clk)
+{
+    RCC->APB2ENR |= apb2_clk;
+    (void)RCC->APB2ENR;     // 等时钟生效再访问端口
+
+    for(uint8_t i = 0; i < num; i++)
+    {
+        const pin_cfg_port_t *p = &tbl[i];
+        if((p->crl_mask | p->crh_mask) == 0U) continue;
+
+        p->port->BSRR = p->safe_bsrr;
+        if(p->crl_mask) p->port->CRL = (p->port->CRL & ~p->crl_mask) | p->crl_val;
+        if(p->crh_mask) p->port->CRH = (p->port->CRH & ~p->crh_mask) | p->crh_val;
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef HEAT_DIAG_H
+#define HEAT_DIAG_H
+
+#include "heat_out_drv.h"
+#include "heat_pwm.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 加热器诊断参数（电流均为ADC原始值）
+ *
+ * 两路电流采样各覆盖4路加热器（HEAT_CURRENTx_CH_MASK），所以不能直接读到单路电流。
+ * 诊断引擎对每个“输出组合不变”的时间窗求平均电流，再做归因：
+ *   - 组内全关的窗口     ：学习零点（第一个全关窗口直接作初值）；之后零点明显抬高 = 某路输出短路常通
+ *   - 组内只开一路的窗口 ：减去零点得到该路电流特征（零点初始化之后）
+ *   - 相邻两个窗口只差一路：两窗口电流之差就是该路电流特征
+ * 每路维护一个电流特征（平均导通电流），据此判断开路/过流/阻值漂移。
+ */
+#define HEAT_DIAG_SETTLE_FRAMES     8U      // 输出切换后丢弃的帧数（开关+采样电路稳定）
+#define HEAT_DIAG_MIN_FRAMES        16U     // 一个窗口至少的有效帧数
+#define HEAT_DIAG_WINDOW_FRAMES     256U    // 输出长时间不变时，每这么多帧结算一次
+#define HEAT_DIAG_NOMINAL_RAW       HEAT_PWM_HEATER_CURRENT_RAW     // 单路额定电流
+#define HEAT_DIAG_OPEN_PCT          25U     // 特征低于额定的该百分比 = 开路
+#define HEAT_DIAG_OVER_PCT          150U    // 特征高于额定的该百分比 = 过流（负载短路）
+#define HEAT_DIAG_SHORT_PCT         50U     // 全关时电流高于额定的该百分比 = 输出短路常通
+#define HEAT_DIAG_DRIFT_PERMILLE    100U    // 特征偏离基线超过该千分比 = 阻值漂移
+#define HEAT_DIAG_CONFIRM           3U      // 连续多少次观测一致才确认故障
+#define HEAT_DIAG_BASELINE_OBS      8U      // 首次学习基线需要的观测次数
+
+typedef enum{
+    HEAT_DIAG_UNKNOWN = 0,  // 观测不足
+    HEAT_DIAG_OK,
+    HEAT_DIAG_OPEN,         // 加热丝断/输出打不开
+    HEAT_DIAG_SHORTED,      // 输出短路常通（指令关仍有电流）
+    HEAT_DIAG_OVERCURRENT,  // 电流远大于额定（负载短路）
+    HEAT_DIAG_DRIFT         // 阻值相对基线漂移
+}heat_diag_status_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void heat_diag_init(void);
+heat_diag_status_t heat_diag_get_status(heat_out_ch_t ch);
+uint16_t heat_diag_get_signature_raw(heat_out_ch_t ch);
+int16_t heat_diag_get_drift_permille(heat_out_ch_t ch);
+void heat_diag_capture_baseline(void);
+void heat_diag_clear(heat_out_ch_t ch);
+
+#endif // HEAT_DIAG_H
@@ -0,0 +1,55 @@
+#ifndef HEAT_GUARD_H
+#define HEAT_GUARD_H
+
+#include "heat_out_drv.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 热保护（独立于 PID/上位机的最后一道防线）
+ * 每路NTC和它加热的若干路热控输出组成一对，保护只看 NTC 原始采样和实际输出状态，
+ * 不依赖温控环路和通信。检测到故障立即 heat_out_inhibit 关断该对的加热器并锁存，
+ * 需要 heat_guard_clear 手动解除。
+ *
+ * 故障判定每 HEAT_GUARD_PERIOD_MS 做一次，连续 HEAT_GUARD_CONFIRM 次才动作，
+ * 最坏响应 = 周期*确认次数（HEAT_GUARD_RESPONSE_MS），需小于温控周期，
+ * heat_pid 据此限制周期下限（HEAT_PID_PERIOD_MS_MIN）。
+ */
+typedef enum{
+    HEAT_GUARD_NTC1 = 0,
+    HEAT_GUARD_NTC2,
+    HEAT_GUARD_NTC_NUM
+}heat_guard_ntc_t;
+
+#define HEAT_GUARD_PERIOD_MS            100U    // 判定间隔
+#define HEAT_GUARD_CONFIRM              3U      // 连续多少次异常才动作（滤掉单点毛刺）
+#define HEAT_GUARD_RESPONSE_MS          (HEAT_GUARD_PERIOD_MS * HEAT_GUARD_CONFIRM)
+#define HEAT_GUARD_TEMP_MAX_CENTI       15000   // 默认温度上限 150℃（0.01℃）
+#define HEAT_GUARD_RATE_WINDOW          10U     // 升温速率窗口（判定次数，10*100ms = 1s）
+#define HEAT_GUARD_RATE_MAX_CENTI       500     // 默认速率上限：窗口内升温超过 5℃ = 失控
+#define HEAT_GUARD_STALL_WINDOW_MS      60000UL // 默认“加热不升温”观察窗口，0=不检查
+#define HEAT_GUARD_STALL_DUTY_PERMILLE  800U    // 窗口内实测导通不低于允许占空比（降额、错峰后）的该比例才算“在加热”
+#define HEAT_GUARD_STALL_RISE_CENTI     200     // 默认窗口内至少应升温 2℃
+
+typedef enum{
+    HEAT_GUARD_OK = 0,
+    HEAT_GUARD_NTC_SHORT,   // 转换结果 -273.15：NTC短路
+    HEAT_GUARD_NTC_OPEN,    // 转换结果 999.0：NTC断路
+    HEAT_GUARD_OVER_TEMP,   // 超过温度上限
+    HEAT_GUARD_RUNAWAY,     // 升温速率超过上限
+    HEAT_GUARD_NO_RISE      // 持续加热但温度不升（NTC脱落/加热器未贴合）
+}heat_guard_fault_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void heat_guard_init(void);
+void heat_guard_set_heaters(heat_guard_ntc_t ntc, uint8_t heater_mask);
+void heat_guard_set_temp_max(int32_t temp_max_centi);
+void heat_guard_set_rate_max(int32_t rise_centi_per_window);
+void heat_guard_set_stall_check(uint32_t window_ms, int32_t min_rise_centi);
+heat_guard_fault_t heat_guard_get_fault(heat_guard_ntc_t ntc);
+int32_t heat_guard_get_temp(heat_guard_ntc_t ntc);
+uint8_t heat_guard_clear(heat_guard_ntc_t ntc);
+void heat_guard_tick_1ms(void);
+
+#endif // HEAT_GUARD_H
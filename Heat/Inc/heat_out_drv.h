@@ -30,5 +30,10 @@ typedef enum{
  ******************************************************************************/
 void heat_out_init_register(void);
 void heat_out_set(heat_out_ch_t ch, uint8_t on);
+void heat_out_set_mask(uint8_t mask);
+uint8_t heat_out_get_mask(void);
+void heat_out_inhibit(uint8_t mask);
+void heat_out_release(uint8_t mask);
+uint8_t heat_out_get_inhibit(void);
 
 #endif // HEAT_OUT_DRV_H
\ No newline at end of file
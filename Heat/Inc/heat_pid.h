@@ -0,0 +1,74 @@
+#ifndef HEAT_PID_H
+#define HEAT_PID_H
+
+#include "heat_out_drv.h"
+#include "heat_guard.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 温区定义
+ * 每个温区用一路NTC做反馈，驱动一组热控输出（heater_mask，bit i = HEAT_OUTi+1）。
+ * 默认：温区1 = NTC1 + HEAT1~4，温区2 = NTC2 + HEAT5~8，运行时可改。
+ */
+typedef enum{
+    HEAT_ZONE1 = 0,
+    HEAT_ZONE2,
+    HEAT_ZONE_NUM
+}heat_zone_t;
+
+#define HEAT_PID_PERIOD_MS_DEFAULT   500U   // 默认控制周期
+#define HEAT_PID_PERIOD_MS_MIN       (HEAT_GUARD_RESPONSE_MS + HEAT_GUARD_PERIOD_MS)  // 保证热保护在一个控制周期内动作
+#define HEAT_PID_GAIN_SHIFT          10     // 增益定点格式 Q10（实际值 = 整数/1024）
+#define HEAT_PID_AUTOTUNE_CYCLES     4U     // 自整定取平均的振荡周期数（不含第一个）
+#define HEAT_PID_AUTOTUNE_TIMEOUT_MS (60UL * 60UL * 1000UL)  // 自整定超时 1 小时
+
+/**
+ * @brief PID增益（Q10定点）
+ * 温度单位 0.01℃，输出单位千分比：
+ *   kp：‰ / ℃
+ *   ki：‰ / (℃·s)
+ *   kd：‰·s / ℃
+ */
+typedef struct{
+    int32_t kp;
+    int32_t ki;
+    int32_t kd;
+}heat_pid_gains_t;
+
+typedef enum{
+    HEAT_PID_OFF = 0,   // 不控制，不改动输出
+    HEAT_PID_RUN,       // 闭环控制
+    HEAT_PID_TUNE,      // 继电器自整定中
+    HEAT_PID_FAULT      // 传感器异常，输出已清零
+}heat_pid_mode_t;
+
+typedef enum{
+    HEAT_TUNE_IDLE = 0,
+    HEAT_TUNE_RUNNING,
+    HEAT_TUNE_DONE,
+    HEAT_TUNE_FAILED
+}heat_tune_state_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void heat_pid_init(void);
+void heat_pid_set_period_ms(uint16_t period_ms);
+uint16_t heat_pid_get_period_ms(void);
+void heat_pid_set_gains(heat_zone_t zone, const heat_pid_gains_t *gains);
+void heat_pid_get_gains(heat_zone_t zone, heat_pid_gains_t *gains);
+void heat_pid_set_heaters(heat_zone_t zone, uint8_t heater_mask);
+void heat_pid_set_setpoint(heat_zone_t zone, int32_t setpoint_centi);
+void heat_pid_enable(heat_zone_t zone, uint8_t on);
+heat_pid_mode_t heat_pid_get_mode(heat_zone_t zone);
+int32_t heat_pid_get_temp(heat_zone_t zone);
+uint16_t heat_pid_get_output(heat_zone_t zone);
+
+uint8_t heat_pid_autotune_start(heat_zone_t zone, int32_t setpoint_centi,
+                                uint16_t relay_permille, int32_t hyst_centi);
+void heat_pid_autotune_abort(heat_zone_t zone);
+heat_tune_state_t heat_pid_autotune_state(heat_zone_t zone);
+
+void heat_pid_tick_1ms(void);
+
+#endif // HEAT_PID_H
@@ -0,0 +1,62 @@
+#ifndef HEAT_PWM_H
+#define HEAT_PWM_H
+
+#include "heat_out_drv.h"
+/******************************************************************************
+ *                              宏定义
+ ******************************************************************************/
+/**
+ * @brief 慢速PWM（时间比例）参数
+ * 热控输出接的是加热丝，热惯性以秒计，所以用几百毫秒~几秒的周期做时间比例控制：
+ * 一个周期内前 on_ticks 个节拍打开，其余关闭，平均功率 = 占空比。
+ */
+#define HEAT_PWM_TICK_MS            1U      // heat_pwm_tick 调用间隔（SysTick 1ms）
+#define HEAT_PWM_PERIOD_MS_DEFAULT  1000U   // 默认周期
+#define HEAT_PWM_PERIOD_MS_MIN      100U    // 周期下限，避免外部开关过于频繁
+#define HEAT_PWM_PERIOD_MS_MAX      60000U  // 周期上限
+#define HEAT_PWM_PERMILLE_MAX       1000U   // 功率设定满量程（千分比）
+#define HEAT_PWM_SD_BASE_MS_DEFAULT 10U     // Σ-Δ 默认判定间隔（单次开/关最短时间）
+
+/**
+ * @brief 调制方式
+ * SLOW_PWM   ：固定周期时间比例，一个周期内一段连续打开，可错峰限流
+ * SIGMA_DELTA：一阶 Σ-Δ（Bresenham），每个基准节拍判定开/关，
+ *              能量在时间上最均匀，供电纹波最小、热响应最快
+ * 两种方式都遵守同时导通路数上限（见下）
+ */
+typedef enum{
+    HEAT_PWM_MODE_SLOW_PWM = 0,
+    HEAT_PWM_MODE_SIGMA_DELTA
+}heat_pwm_mode_t;
+
+/**
+ * @brief 错峰调度参数
+ * 各路打开窗口在周期内错开排列，同时导通的路数不超过上限，避免供电跌落。
+ * 实测用 HEAT_CURRENT1/2 核验：周期内总电流峰值不应超过 上限*单路额定电流*余量。
+ */
+#define HEAT_PWM_MAX_ON_DEFAULT     4U      // 默认同时导通路数上限
+#define HEAT_PWM_HEATER_CURRENT_RAW 600U    // 单路加热器额定电流对应的ADC原始值（按硬件标定）
+#define HEAT_PWM_CURRENT_MARGIN_PCT 125U    // 核验余量（%）
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void heat_pwm_init(uint16_t period_ms);
+void heat_pwm_set_period(uint16_t period_ms);
+uint16_t heat_pwm_get_period(void);
+void heat_pwm_set_permille(heat_out_ch_t ch, uint16_t permille);
+uint16_t heat_pwm_get_permille(heat_out_ch_t ch);
+const volatile uint16_t *heat_pwm_permille_table(void);
+void heat_pwm_set_power_cap(uint16_t cap_permille);
+uint16_t heat_pwm_get_power_cap(void);
+void heat_pwm_set_mode(heat_pwm_mode_t mode);
+heat_pwm_mode_t heat_pwm_get_mode(void);
+void heat_pwm_set_sd_base_ms(uint16_t base_ms);
+void heat_pwm_set_max_on(uint8_t max_on);
+uint8_t heat_pwm_get_max_on(void);
+uint16_t heat_pwm_get_allowed_permille(void);
+uint8_t heat_pwm_is_overloaded(void);
+uint16_t heat_pwm_get_peak_current_raw(void);
+uint32_t heat_pwm_get_overcurrent_count(void);
+void heat_pwm_tick(void);
+
+#endif // HEAT_PWM_H
@@ -0,0 +1,316 @@
+#include "heat_diag.h"
+#include "adc_frame.h"
+
+/***************************************************************
+ * 内部类型
+ ***************************************************************/
+
+#define HEAT_DIAG_GROUP_NUM  2
+
+/**
+ * @brief 单个电流采样组的窗口状态
+ */
+typedef struct{
+    uint8_t  ch_mask;       // 本组覆盖的通道
+    uint8_t  adc_ch;        // 帧内通道序号
+    uint8_t  cur_mask;      // 当前窗口的组内输出组合
+    uint16_t settle;        // 剩余丢弃帧数
+    uint32_t sum;           // 窗口内采样累加
+    uint16_t n;             // 窗口内有效帧数
+    uint8_t  last_valid;    // 上一个结算窗口是否有效
+    uint8_t  last_mask;     // 上一个结算窗口的输出组合
+    uint16_t last_avg;      // 上一个结算窗口的平均电流
+    int32_t  offset_q4;     // 全关零点（Q4）
+    uint8_t  zeroed;        // 零点已由第一个全关窗口初始化
+    uint8_t  hold;          // 疑似输出短路：组内观测不可信，暂停学习特征
+}heat_diag_group_t;
+
+/**
+ * @brief 单路加热器的电流特征与故障判定
+ */
+typedef struct{
+    int32_t  sig_q4;        // 电流特征 EWMA（Q4）
+    uint16_t obs;           // 有效观测次数
+    uint16_t baseline;      // 基线特征（0=未学习）
+    uint8_t  pend;          // 候选故障
+    uint8_t  pend_cnt;      // 候选故障连续次数
+    heat_diag_status_t status;
+}heat_diag_ch_t;
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static heat_diag_group_t s_group[HEAT_DIAG_GROUP_NUM];
+static heat_diag_ch_t s_ch[HEAT_OUT_NUM];
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint8_t popcount8(uint8_t v)
+{
+    uint8_t n = 0;
+    while(v) { v &= (uint8_t)(v - 1U); n++; }
+    return n;
+}
+
+static uint8_t lowest_bit(uint8_t v)
+{
+    uint8_t i = 0;
+    while(!(v & 1U)) { v >>= 1; i++; }
+    return i;
+}
+
+/**
+ * @brief 故障去抖：同一结论连续 HEAT_DIAG_CONFIRM 次才生效
+ * @note  SHORTED 是锁存的，只能由 heat_diag_clear 清除
+ */
+static void heat_diag_vote(heat_diag_ch_t *c, heat_diag_status_t verdict)
+{
+    if(c->status == HEAT_DIAG_SHORTED) return;
+
+    if(verdict != c->pend)
+    {
+        c->pend = (uint8_t)verdict;
+        c->pend_cnt = 1;
+    }
+    else if(c->pend_cnt < 0xFF)
+    {
+        c->pend_cnt++;
+    }
+
+    if(c->pend_cnt >= HEAT_DIAG_CONFIRM) c->status = verdict;
+}
+
+/**
+ * @brief 用一次观测值更新某路特征并判定
+ */
+static void heat_diag_observe(uint8_t ch, int32_t sig)
+{
+    heat_diag_ch_t *c = &s_ch[ch];
+
+    if(sig < 0) sig = 0;
+    if(c->obs == 0) c->sig_q4 = sig << 4;
+    else            c->sig_q4 += ((sig << 4) - c->sig_q4) >> 2;
+    if(c->obs < 0xFFFF) c->obs++;
+
+    int32_t s = c->sig_q4 >> 4;
+
+    if(c->baseline == 0 && c->obs >= HEAT_DIAG_BASELINE_OBS
+       && s >= (int32_t)(HEAT_DIAG_NOMINAL_RAW * HEAT_DIAG_OPEN_PCT / 100U))
+    {
+        c->baseline = (uint16_t)s;   // 第一次稳定学到的特征作为基线
+    }
+
+    heat_diag_status_t verdict = HEAT_DIAG_OK;
+    if(s < (int32_t)(HEAT_DIAG_NOMINAL_RAW * HEAT_DIAG_OPEN_PCT / 100U))
+    {
+        verdict = HEAT_DIAG_OPEN;
+    }
+    else if(s > (int32_t)(HEAT_DIAG_NOMINAL_RAW * HEAT_DIAG_OVER_PCT / 100U))
+    {
+        verdict = HEAT_DIAG_OVERCURRENT;
+    }
+    else if(c->baseline != 0)
+    {
+        int32_t dev = (s - (int32_t)c->baseline) * 1000 / (int32_t)c->baseline;
+        if(dev < 0) dev = -dev;
+        if(dev > (int32_t)HEAT_DIAG_DRIFT_PERMILLE) verdict = HEAT_DIAG_DRIFT;
+    }
+    heat_diag_vote(c, verdict);
+}
+
+/**
+ * @brief 组内全关但零点抬高：按基线特征最接近的一路归因为输出短路
+ * @note  常通的那一路叠加在组内所有窗口上，发现之前学到的特征已被污染，
+ *        所以优先用基线比对；确认后组内其它通道的结论作废，特征回到基线重新观测
+ */
+static void heat_diag_attribute_short(heat_diag_group_t *g, int32_t excess)
+{
+    int32_t best_err = 0x7FFFFFFF;
+    int8_t best = -1;
+
+    for(uint8_t i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        if(!(g->ch_mask & (1U << i))) continue;
+        int32_t ref = (s_ch[i].baseline != 0) ? (int32_t)s_ch[i].baseline
+                    : (s_ch[i].obs != 0) ? (s_ch[i].sig_q4 >> 4) : (int32_t)HEAT_DIAG_NOMINAL_RAW;
+        int32_t err = excess - ref;
+        if(err < 0) err = -err;
+        if(err < best_err) { best_err = err; best = (int8_t)i; }
+    }
+    if(best < 0) return;
+
+    heat_diag_ch_t *c = &s_ch[best];
+    if(c->status == HEAT_DIAG_SHORTED) return;
+    if(c->pend != HEAT_DIAG_SHORTED) { c->pend = HEAT_DIAG_SHORTED; c->pend_cnt = 0; }
+    if(++c->pend_cnt < HEAT_DIAG_CONFIRM) return;
+
+    c->status = HEAT_DIAG_SHORTED;
+    for(uint8_t i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        if(!(g->ch_mask & (1U << i)) || i == (uint8_t)best) continue;
+        heat_diag_ch_t *o = &s_ch[i];
+        if(o->status == HEAT_DIAG_SHORTED) continue;
+        o->status = HEAT_DIAG_UNKNOWN;
+        o->pend = HEAT_DIAG_UNKNOWN;
+        o->pend_cnt = 0;
+        if(o->baseline != 0) o->sig_q4 = (int32_t)o->baseline << 4;
+    }
+}
+
+/**
+ * @brief 结算一个窗口：按输出组合做归因
+ */
+static void heat_diag_close_window(heat_diag_group_t *g)
+{
+    if(g->n < HEAT_DIAG_MIN_FRAMES)
+    {
+        g->last_valid = 0;
+        return;
+    }
+
+    uint16_t avg = (uint16_t)(g->sum / g->n);
+    uint8_t m = g->cur_mask;
+    int32_t offset = g->offset_q4 >> 4;
+
+    if(m == 0 && !g->zeroed)
+    {
+        // 第一个全关窗口直接作零点：电流放大器的失调因板而异，不能假定从 0 起步
+        g->offset_q4 = (int32_t)avg << 4;
+        g->zeroed = 1;
+    }
+    else if(m == 0)
+    {
+        int32_t excess = (int32_t)avg - offset;
+        if(excess > (int32_t)(HEAT_DIAG_NOMINAL_RAW * HEAT_DIAG_SHORT_PCT / 100U))
+        {
+            g->hold = 1;
+            heat_diag_attribute_short(g, excess);   // 零点不跟着抬高
+        }
+        else
+        {
+            g->hold = 0;
+            g->offset_q4 += (((int32_t)avg << 4) - g->offset_q4) >> 3;
+        }
+    }
+    else if(g->hold)
+    {
+        // 疑似短路期间不学习特征
+    }
+    else if(popcount8(m) == 1 && g->zeroed)
+    {
+        heat_diag_observe(lowest_bit(m), (int32_t)avg - offset);
+    }
+    else if(g->last_valid && popcount8((uint8_t)(m ^ g->last_mask)) == 1)
+    {
+        uint8_t k = lowest_bit((uint8_t)(m ^ g->last_mask));
+        int32_t d = (m & (1U << k)) ? ((int32_t)avg - g->last_avg) : ((int32_t)g->last_avg - avg);
+        heat_diag_observe(k, d);
+    }
+
+    g->last_valid = 1;
+    g->last_mask = m;
+    g->last_avg = avg;
+}
+
+/**
+ * @brief ADC帧回调：按当前输出组合累加各组电流
+ */
+static void heat_diag_on_adc_frame(const uint16_t *frame)
+{
+    uint8_t out = heat_out_get_mask();
+
+    for(int i = 0; i < HEAT_DIAG_GROUP_NUM; i++)
+    {
+        heat_diag_group_t *g = &s_group[i];
+        uint8_t m = out & g->ch_mask;
+
+        if(m != g->cur_mask)
+        {
+            heat_diag_close_window(g);
+            g->cur_mask = m;
+            g->settle = HEAT_DIAG_SETTLE_FRAMES;
+            g->sum = 0;
+            g->n = 0;
+            continue;
+        }
+
+        if(g->settle) { g->settle--; continue; }
+
+        g->sum += frame[g->adc_ch];
+        if(++g->n >= HEAT_DIAG_WINDOW_FRAMES)
+        {
+            heat_diag_close_window(g);
+            g->sum = 0;
+            g->n = 0;
+        }
+    }
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化诊断引擎并挂到ADC帧流上
+ */
+void heat_diag_init(void)
+{
+    for(int i = 0; i < HEAT_DIAG_GROUP_NUM; i++) s_group[i] = (heat_diag_group_t){0};
+    for(int i = 0; i < HEAT_OUT_NUM; i++)        s_ch[i] = (heat_diag_ch_t){0};
+
+    s_group[0].ch_mask = HEAT_CURRENT1_CH_MASK;
+    s_group[0].adc_ch  = ADC_FRAME_HEAT_CURRENT1;
+    s_group[1].ch_mask = HEAT_CURRENT2_CH_MASK;
+    s_group[1].adc_ch  = ADC_FRAME_HEAT_CURRENT2;
+
+    adc_frame_register_hook(heat_diag_on_adc_frame);
+}
+
+heat_diag_status_t heat_diag_get_status(heat_out_ch_t ch)
+{
+    if(ch >= HEAT_OUT_NUM) return HEAT_DIAG_UNKNOWN;
+    return s_ch[ch].status;
+}
+
+/**
+ * @brief 当前电流特征（单路导通电流，ADC原始值）
+ */
+uint16_t heat_diag_get_signature_raw(heat_out_ch_t ch)
+{
+    if(ch >= HEAT_OUT_NUM) return 0;
+    return (uint16_t)(s_ch[ch].sig_q4 >> 4);
+}
+
+/**
+ * @brief 特征相对基线的偏差（‰），电流变小 = 阻值变大 = 负值
+ */
+int16_t heat_diag_get_drift_permille(heat_out_ch_t ch)
+{
+    if(ch >= HEAT_OUT_NUM || s_ch[ch].baseline == 0) return 0;
+    return (int16_t)(((s_ch[ch].sig_q4 >> 4) - (int32_t)s_ch[ch].baseline) * 1000 / (int32_t)s_ch[ch].baseline);
+}
+
+/**
+ * @brief 以当前特征重新作为基线（更换加热器/出厂标定后调用）
+ */
+void heat_diag_capture_baseline(void)
+{
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        if(s_ch[i].obs != 0) s_ch[i].baseline = (uint16_t)(s_ch[i].sig_q4 >> 4);
+    }
+}
+
+/**
+ * @brief 清除某路故障（含锁存的短路），重新观测
+ */
+void heat_diag_clear(heat_out_ch_t ch)
+{
+    if(ch >= HEAT_OUT_NUM) return;
+    uint16_t baseline = s_ch[ch].baseline;
+    s_ch[ch] = (heat_diag_ch_t){0};
+    s_ch[ch].baseline = baseline;
+}
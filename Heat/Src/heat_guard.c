@@ -0,0 +1,276 @@
+#include "heat_guard.h"
+#include "heat_pwm.h"
+#include "adc_frame.h"
+#include "thermistor_temperature_driver.h"
+
+/***************************************************************
+ * 内部类型
+ ***************************************************************/
+
+typedef struct{
+    uint8_t  heater_mask;   // 该NTC负责监视的热控输出
+    heat_guard_fault_t fault;   // 已动作的故障（锁存）
+    uint8_t  pend;          // 候选故障
+    uint8_t  pend_cnt;      // 候选故障连续次数
+    uint8_t  valid;         // 最近一次读数有效
+    int32_t  temp;          // 最近一次温度（0.01℃）
+    int32_t  hist[HEAT_GUARD_RATE_WINDOW];  // 速率窗口历史
+    uint8_t  hist_idx;
+    uint8_t  hist_n;
+    uint32_t stall_on;      // 窗口内 Σ(导通路数 × ms)
+    uint32_t stall_allow;   // 窗口内 Σ(每路允许占空比‰ × ms)
+    uint32_t stall_ms;      // 窗口已过时间
+    int32_t  stall_start;   // 窗口起点温度
+}heat_guard_pair_t;
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static heat_guard_pair_t s_pair[HEAT_GUARD_NTC_NUM];
+static uint8_t s_inhibit = 0;   // 本模块施加的禁止掩码
+static int32_t s_temp_max = HEAT_GUARD_TEMP_MAX_CENTI;
+static int32_t s_rate_max = HEAT_GUARD_RATE_MAX_CENTI;
+static uint32_t s_stall_window_ms = HEAT_GUARD_STALL_WINDOW_MS;
+static int32_t s_stall_rise = HEAT_GUARD_STALL_RISE_CENTI;
+static uint16_t s_tick_ms = 0;
+static volatile uint8_t s_inited = 0;
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint8_t popcount8(uint8_t v)
+{
+    uint8_t n = 0;
+    while(v) { v &= (uint8_t)(v - 1U); n++; }
+    return n;
+}
+
+/**
+ * @brief 按所有已动作故障重新计算禁止掩码，只解除不再被任何故障覆盖的通道
+ */
+static void heat_guard_sync_inhibit(void)
+{
+    uint8_t want = 0;
+    for(int i = 0; i < HEAT_GUARD_NTC_NUM; i++)
+    {
+        if(s_pair[i].fault != HEAT_GUARD_OK) want |= s_pair[i].heater_mask;
+    }
+    if(s_inhibit & (uint8_t)~want) heat_out_release(s_inhibit & (uint8_t)~want);
+    if(want) heat_out_inhibit(want);    // 每次都重新关断，覆盖运行中改过的配对
+    s_inhibit = want;
+}
+
+static void heat_guard_restart_windows(heat_guard_pair_t *p)
+{
+    p->hist_idx = 0;
+    p->hist_n = 0;
+    p->stall_on = 0;
+    p->stall_allow = 0;
+    p->stall_ms = 0;
+    p->stall_start = p->temp;
+}
+
+/**
+ * @brief 读取NTC并给出本次判定
+ */
+static heat_guard_fault_t heat_guard_evaluate(heat_guard_pair_t *p, heat_guard_ntc_t ntc)
+{
+    uint16_t raw = adc_frame_get_raw((adc_frame_ch_t)(ADC_FRAME_NTC1 + ntc));
+    int32_t t = convert_analog_to_digital_converter_value_to_temperature_centi_celsius(raw);
+
+    // -273.15 = 短路，999.0 = 断路（见转换函数的边界保护）
+    if(t == THERMISTOR_CENTI_SHORT || t == THERMISTOR_CENTI_OPEN)
+    {
+        p->valid = 0;
+        return (t == THERMISTOR_CENTI_SHORT) ? HEAT_GUARD_NTC_SHORT : HEAT_GUARD_NTC_OPEN;
+    }
+
+    p->temp = t;
+    if(!p->valid)
+    {
+        p->valid = 1;
+        heat_guard_restart_windows(p);   // 传感器刚恢复，历史不可信
+    }
+
+    if(p->temp > s_temp_max) return HEAT_GUARD_OVER_TEMP;
+
+    // 升温速率：与一个窗口前的温度比较
+    int32_t oldest = p->hist[p->hist_idx];
+    uint8_t full = (p->hist_n >= HEAT_GUARD_RATE_WINDOW);
+    p->hist[p->hist_idx] = p->temp;
+    if(++p->hist_idx >= HEAT_GUARD_RATE_WINDOW) p->hist_idx = 0;
+    if(!full) p->hist_n++;
+    if(full && p->temp - oldest > s_rate_max) return HEAT_GUARD_RUNAWAY;
+
+    // 加热不升温：实测导通接近允许的上限（降额、错峰后）却没升到最小温升
+    if(s_stall_window_ms != 0 && p->heater_mask != 0)
+    {
+        p->stall_ms += HEAT_GUARD_PERIOD_MS;
+        if(p->stall_ms >= s_stall_window_ms)
+        {
+            uint64_t allow = (uint64_t)p->stall_allow * popcount8(p->heater_mask);
+            uint32_t duty = (allow == 0U) ? 0U
+                          : (uint32_t)((uint64_t)p->stall_on * 1000U * HEAT_PWM_PERMILLE_MAX / allow);
+            uint8_t stalled = (duty >= HEAT_GUARD_STALL_DUTY_PERMILLE)
+                            && (p->temp - p->stall_start < s_stall_rise);
+            p->stall_on = 0;
+            p->stall_allow = 0;
+            p->stall_ms = 0;
+            p->stall_start = p->temp;
+            if(stalled) return HEAT_GUARD_NO_RISE;
+        }
+    }
+    return HEAT_GUARD_OK;
+}
+
+static void heat_guard_check(heat_guard_pair_t *p, heat_guard_ntc_t ntc)
+{
+    heat_guard_fault_t v = heat_guard_evaluate(p, ntc);
+
+    if(v == HEAT_GUARD_OK)
+    {
+        p->pend = HEAT_GUARD_OK;
+        p->pend_cnt = 0;
+        return;
+    }
+    if(v != p->pend)
+    {
+        p->pend = (uint8_t)v;
+        p->pend_cnt = 0;
+    }
+    if(p->pend_cnt < 0xFF) p->pend_cnt++;
+
+    // 不升温是整个窗口的统计结论，不再重复确认
+    if(p->pend_cnt < HEAT_GUARD_CONFIRM && v != HEAT_GUARD_NO_RISE) return;
+
+    if(p->fault == HEAT_GUARD_OK)
+    {
+        p->fault = v;
+        heat_guard_sync_inhibit();
+    }
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化热保护，默认配对与温控一致：NTC1 = HEAT1~4，NTC2 = HEAT5~8
+ * @note  配对表与温控模块各自独立保存，温控改配对不会影响保护
+ */
+void heat_guard_init(void)
+{
+    s_inited = 0;
+    for(int i = 0; i < HEAT_GUARD_NTC_NUM; i++) s_pair[i] = (heat_guard_pair_t){0};
+    s_pair[HEAT_GUARD_NTC1].heater_mask = 0x0F;
+    s_pair[HEAT_GUARD_NTC2].heater_mask = 0xF0;
+    s_inhibit = 0;
+    s_tick_ms = 0;
+
+    adc_frame_init();
+    s_inited = 1;
+}
+
+/**
+ * @brief 修改某路NTC监视的加热器；已处于故障时新配对立即生效
+ */
+void heat_guard_set_heaters(heat_guard_ntc_t ntc, uint8_t heater_mask)
+{
+    if(ntc >= HEAT_GUARD_NTC_NUM) return;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    s_pair[ntc].heater_mask = heater_mask;
+    heat_guard_restart_windows(&s_pair[ntc]);
+    heat_guard_sync_inhibit();
+    __set_PRIMASK(primask);
+}
+
+void heat_guard_set_temp_max(int32_t temp_max_centi)
+{
+    s_temp_max = temp_max_centi;
+}
+
+/**
+ * @param rise_centi_per_window 一个速率窗口（HEAT_GUARD_RATE_WINDOW 次判定）内允许的最大升温
+ */
+void heat_guard_set_rate_max(int32_t rise_centi_per_window)
+{
+    s_rate_max = rise_centi_per_window;
+}
+
+/**
+ * @param window_ms      观察窗口，0=关闭“加热不升温”检查
+ * @param min_rise_centi 窗口内实测导通 >= 允许占空比 × HEAT_GUARD_STALL_DUTY_PERMILLE‰ 时应达到的最小温升
+ */
+void heat_guard_set_stall_check(uint32_t window_ms, int32_t min_rise_centi)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    s_stall_window_ms = window_ms;
+    s_stall_rise = min_rise_centi;
+    for(int i = 0; i < HEAT_GUARD_NTC_NUM; i++) heat_guard_restart_windows(&s_pair[i]);
+    __set_PRIMASK(primask);
+}
+
+heat_guard_fault_t heat_guard_get_fault(heat_guard_ntc_t ntc)
+{
+    if(ntc >= HEAT_GUARD_NTC_NUM) return HEAT_GUARD_OK;
+    return s_pair[ntc].fault;
+}
+
+int32_t heat_guard_get_temp(heat_guard_ntc_t ntc)
+{
+    if(ntc >= HEAT_GUARD_NTC_NUM) return 0;
+    return s_pair[ntc].temp;
+}
+
+/**
+ * @brief 解除故障锁存
+ * @return 1=已解除，0=故障条件仍在（读数无效或仍超限），保持关断
+ */
+uint8_t heat_guard_clear(heat_guard_ntc_t ntc)
+{
+    if(ntc >= HEAT_GUARD_NTC_NUM) return 0;
+    heat_guard_pair_t *p = &s_pair[ntc];
+    uint8_t ok = 0;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(p->valid && p->pend == HEAT_GUARD_OK && p->temp <= s_temp_max)
+    {
+        p->fault = HEAT_GUARD_OK;
+        heat_guard_restart_windows(p);
+        heat_guard_sync_inhibit();
+        ok = 1;
+    }
+    __set_PRIMASK(primask);
+    return ok;
+}
+
+/**
+ * @brief 1ms节拍（SysTick中断）：每拍统计加热器导通，每 HEAT_GUARD_PERIOD_MS 判定一次
+ */
+void heat_guard_tick_1ms(void)
+{
+    if(!s_inited) return;
+
+    uint8_t out = heat_out_get_mask();
+    uint16_t allow = heat_pwm_get_allowed_permille();
+    for(int i = 0; i < HEAT_GUARD_NTC_NUM; i++)
+    {
+        s_pair[i].stall_on += popcount8(out & s_pair[i].heater_mask);
+        s_pair[i].stall_allow += allow;
+    }
+
+    if(++s_tick_ms < HEAT_GUARD_PERIOD_MS) return;
+    s_tick_ms = 0;
+
+    for(int i = 0; i < HEAT_GUARD_NTC_NUM; i++)
+    {
+        heat_guard_check(&s_pair[i], (heat_guard_ntc_t)i);
+    }
+}
@@ -1,10 +1,10 @@
 #include "heat_out_drv.h"
+#include "pin_cfg.h"
 #include "stm32f103xe.h"
 
 /******************************************************************************
  *                              函数声明
  ******************************************************************************/
-static void gpio_config_output_pp_50m(GPIO_TypeDef* port, uint16_t pin);
 static void afio_swj_disable_once(void);
 /***************************************************************
  * 关键配置区
@@ -22,8 +22,8 @@ static void afio_swj_disable_once(void);
  * @brief 每一路热控输出对应的GPIO端口/引脚映射表
  *
  * 映射来源于 hardware_config.h：
- * HEAT_CTRL1: PB8
- * HEAT_CTRL2: PB9
+ * HEAT_CTRL1: PB8（USE_CAN_COMM 时 PB6）
+ * HEAT_CTRL2: PB9（USE_CAN_COMM 时 PB7）
  * HEAT_CTRL3: PB10
  * HEAT_CTRL4: PB11
  * HEAT_CTRL5: PC9
@@ -48,50 +48,88 @@ static const heat_out_map_t s_heat_map[HEAT_OUT_NUM] = {
     {HEAT_CTRL8_PORT, HEAT_CTRL8_PIN}  // HEAT_OUT8
 };
 
-/***************************************************************
- * 内部工具函数：把单个GPIO配置为 推挽输出 50MHz（寄存器方式）
- ***************************************************************/
+/**
+ * @brief 8路热控引脚清单，供编译期生成端口表：F(端口, 引脚, 目标端口, a, b)
+ */
+#define HEAT_OUT_PINS(F, gpio, a, b) ( \
+    F(HEAT_CTRL1_PORT, HEAT_CTRL1_PIN, gpio, a, b) | F(HEAT_CTRL2_PORT, HEAT_CTRL2_PIN, gpio, a, b) | \
+    F(HEAT_CTRL3_PORT, HEAT_CTRL3_PIN, gpio, a, b) | F(HEAT_CTRL4_PORT, HEAT_CTRL4_PIN, gpio, a, b) | \
+    F(HEAT_CTRL5_PORT, HEAT_CTRL5_PIN, gpio, a, b) | F(HEAT_CTRL6_PORT, HEAT_CTRL6_PIN, gpio, a, b) | \
+    F(HEAT_CTRL7_PORT, HEAT_CTRL7_PIN, gpio, a, b) | F(HEAT_CTRL8_PORT, HEAT_CTRL8_PIN, gpio, a, b) )
 
 /**
- * STM32F103 GPIO配置说明：
- * - 每个GPIO口有两组配置寄存器：CRL(配置0~7号脚) 和 CRH(配置8~15号脚)
- * - 每个引脚对应4bit配置：
- *   MODE[1:0] + CNF[1:0]
- *
- * 推挽输出50MHz：
- *   MODE = 11 (50MHz输出)
- *   CNF  = 00 (推挽)
- *   => 4bit = 0b0011 = 0x3
-*/
-static void gpio_config_output_pp_50m(GPIO_TypeDef* port, uint16_t pin)
-{
-    //1）打开AFIO时钟
-    RCC->APB2ENR |= RCC_APB2ENR_AFIOEN;
+ * @brief 第 ch 路在 gpio 口上的引脚位（不在该口为 0）
+ */
+#define HEAT_OUT_CH_PIN(ch, gpio)   PIN_CFG_PIN_OF(HEAT_CTRL##ch##_PORT, HEAT_CTRL##ch##_PIN, gpio, 0, 0)
 
-    //2）打开对应GPIO口时钟
-    if(port == GPIOA) RCC->APB2ENR |= RCC_APB2ENR_IOPAEN;
-    if(port == GPIOB) RCC->APB2ENR |= RCC_APB2ENR_IOPBEN;
-    if(port == GPIOC) RCC->APB2ENR |= RCC_APB2ENR_IOPCEN;
-    if(port == GPIOD) RCC->APB2ENR |= RCC_APB2ENR_IOPDEN;
+/**
+ * @brief 上电安全电平：全部关闭
+ */
+#if HEAT_OUT_ACTIVE_HIGH
+    #define HEAT_OUT_SAFE_BSRR(gpio)    (HEAT_OUT_PINS(PIN_CFG_PIN_OF, gpio, 0, 0) << 16)
+#else
+    #define HEAT_OUT_SAFE_BSRR(gpio)    HEAT_OUT_PINS(PIN_CFG_PIN_OF, gpio, 0, 0)
+#endif
 
-    // 3) 计算 pin 对应的编号（0~15）
-    uint8_t pin_num = 0;
-    uint16_t t = pin;
-    while((t >>= 1) != 0) pin_num++;
+/**
+ * @brief 端口配置表（编译期生成）：每口 CRL/CRH 各写一次即完成8路推挽50MHz配置
+ */
+static const pin_cfg_port_t s_heat_pin_cfg[] = {
+    PIN_CFG_PORT(HEAT_OUT_PINS, GPIOA, PIN_CFG_OUT_PP_50M, HEAT_OUT_SAFE_BSRR(GPIOA)),
+    PIN_CFG_PORT(HEAT_OUT_PINS, GPIOB, PIN_CFG_OUT_PP_50M, HEAT_OUT_SAFE_BSRR(GPIOB)),
+    PIN_CFG_PORT(HEAT_OUT_PINS, GPIOC, PIN_CFG_OUT_PP_50M, HEAT_OUT_SAFE_BSRR(GPIOC)),
+    PIN_CFG_PORT(HEAT_OUT_PINS, GPIOD, PIN_CFG_OUT_PP_50M, HEAT_OUT_SAFE_BSRR(GPIOD)),
+};
 
-    // 4) 选择CRL还是CRH
-    volatile uint32_t *cr = (pin_num < 8) ? &port->CRL : &port->CRH;
+#define HEAT_OUT_APB2_CLK   (RCC_APB2ENR_AFIOEN | HEAT_OUT_PINS(PIN_CFG_CLK_OF, 0, 0, 0))
 
-    // 5）找到该引脚4bit字段的偏移
-    uint8_t shift = (pin_num % 8) * 4;
+/**
+ * @brief 按端口的半字节引脚表（编译期生成）
+ * lo[n]：通道掩码低4位 = n 时，本端口要动作的引脚位；hi[n] 对应高4位。
+ */
+typedef struct {
+    GPIO_TypeDef* port;
+    uint16_t      pins;     // 本端口上所有热控引脚
+    uint16_t      lo[16];
+    uint16_t      hi[16];
+}heat_out_port_t;
 
-    //6）先清除原配置
-    *cr &= ~(0xF << shift);
+#define HEAT_OUT_NIB(c0, c1, c2, c3, gpio, n) (uint16_t)( \
+    (((n) & 1U) ? HEAT_OUT_CH_PIN(c0, gpio) : 0U) | (((n) & 2U) ? HEAT_OUT_CH_PIN(c1, gpio) : 0U) | \
+    (((n) & 4U) ? HEAT_OUT_CH_PIN(c2, gpio) : 0U) | (((n) & 8U) ? HEAT_OUT_CH_PIN(c3, gpio) : 0U) )
 
-    //7）设置为 推挽输出 50MHz
-    *cr |= (0x03 << shift);
+#define HEAT_OUT_NIB16(c0, c1, c2, c3, gpio) { \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 0),  HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 1),  \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 2),  HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 3),  \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 4),  HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 5),  \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 6),  HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 7),  \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 8),  HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 9),  \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 10), HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 11), \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 12), HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 13), \
+    HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 14), HEAT_OUT_NIB(c0, c1, c2, c3, gpio, 15) }
 
-}
+#define HEAT_OUT_PORT(gpio) { (gpio), \
+    (uint16_t)HEAT_OUT_PINS(PIN_CFG_PIN_OF, gpio, 0, 0), \
+    HEAT_OUT_NIB16(1, 2, 3, 4, gpio), HEAT_OUT_NIB16(5, 6, 7, 8, gpio) }
+
+static const heat_out_port_t s_heat_port[] = {
+    HEAT_OUT_PORT(GPIOA),
+    HEAT_OUT_PORT(GPIOB),
+    HEAT_OUT_PORT(GPIOC),
+    HEAT_OUT_PORT(GPIOD),
+};
+
+#define HEAT_OUT_PORT_NUM   (sizeof(s_heat_port) / sizeof(s_heat_port[0]))
+
+/**
+ * @brief 当前指令输出状态（bit i = HEAT_OUTi+1 打开），供诊断/保护读取
+ */
+static volatile uint8_t s_heat_state = 0;
+
+/**
+ * @brief 被保护逻辑禁止的通道（bit i = HEAT_OUTi+1），置位后任何打开请求都按关闭处理
+ */
+static volatile uint8_t s_heat_inhibit = 0;
 
 /**
  * @brief 关闭SWJ接口（JTAG+SWD），只保留SWD
@@ -100,7 +138,7 @@ static void gpio_config_output_pp_50m(GPIO_TypeDef* port, uint16_t pin)
  */
 static void afio_swj_disable_once(void)
 {
-    //1）打开AFIO时钟（IO初始化时已经做了）
+    //1）打开AFIO时钟（pin_cfg_apply 已经做了）
 
     //2）关闭JTAG，保留SWD
     AFIO->MAPR |= AFIO_MAPR_SWJ_CFG_JTAGDISABLE;
@@ -120,6 +158,13 @@ void heat_out_set(heat_out_ch_t ch, uint8_t on)
      */
     GPIO_TypeDef *port = s_heat_map[ch].port;
     uint16_t pin = s_heat_map[ch].pin;
+
+    // s_heat_state 也由 heat_pwm 节拍里的 heat_out_set_mask 改写，读-改-写需关中断
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(s_heat_inhibit & (1U << ch)) on = 0;
+    if(on) s_heat_state |= (uint8_t)(1U << ch);
+    else   s_heat_state &= (uint8_t)~(1U << ch);
     #if HEAT_OUT_ACTIVE_HIGH
         // 高电平有效：on=1 输出高，on=0 输出低
         if(on) port->BSRR = pin;   // 置高
@@ -129,7 +174,80 @@ void heat_out_set(heat_out_ch_t ch, uint8_t on)
         if(on) port->BRR  = pin;   // 置低
         else   port->BSRR = pin;   // 置高
     #endif
+    __set_PRIMASK(primask);
+}
+/***************************************************************
+ * 对外接口：8路热控输出一次性全部设置
+ ***************************************************************/
+/**
+ * @param mask bit i = HEAT_OUTi+1 打开
+ * @note  同一端口的置位和复位合并成一次 BSRR 写：
+ *        低16位写1置位，高16位写1复位，同口各脚同时翻转。
+ *        8路分布在 GPIOA/B/C/D 四个口上，所以最多 4 次寄存器写，
+ *        每口的引脚位由两张半字节表查出，不需要逐路循环。
+ */
+void heat_out_set_mask(uint8_t mask)
+{
+    mask &= (uint8_t)~s_heat_inhibit;
+
+    for(uint32_t j = 0; j < HEAT_OUT_PORT_NUM; j++)
+    {
+        const heat_out_port_t *p = &s_heat_port[j];
+        if(p->pins == 0U) continue;
+        uint32_t on  = (uint32_t)p->lo[mask & 0x0FU] | p->hi[mask >> 4];
+        uint32_t off = p->pins & ~on;
+    #if HEAT_OUT_ACTIVE_HIGH
+        p->port->BSRR = on | (off << 16);
+    #else
+        p->port->BSRR = off | (on << 16);
+    #endif
+    }
+    s_heat_state = mask;
+}
+
+/***************************************************************
+ * 对外接口：读取当前指令输出状态
+ ***************************************************************/
+uint8_t heat_out_get_mask(void)
+{
+    return s_heat_state;
+}
+
+/***************************************************************
+ * 对外接口：禁止/解除禁止热控输出（热保护用）
+ ***************************************************************/
+/**
+ * @brief 禁止若干路输出并立即关闭
+ * @note  禁止是锁存的：之后 heat_out_set/heat_out_set_mask 的打开请求都会被屏蔽，
+ *        直到 heat_out_release 解除。上层PWM/PID不需要知道保护的存在。
+ */
+void heat_out_inhibit(uint8_t mask)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s_heat_inhibit |= mask;
+    __set_PRIMASK(primask);
+
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        if(mask & (1U << i)) heat_out_set((heat_out_ch_t)i, 0);
+    }
+}
+
+/**
+ * @brief 解除禁止，输出保持关闭，等上层下一次刷新
+ */
+void heat_out_release(uint8_t mask)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s_heat_inhibit &= (uint8_t)~mask;
+    __set_PRIMASK(primask);
+}
 
+uint8_t heat_out_get_inhibit(void)
+{
+    return s_heat_inhibit;
 }
 /***************************************************************
  * 对外接口：初始化8路热控输出
@@ -151,15 +269,9 @@ void heat_out_init_register(void)
      * 量产固件/已不需要SWD调试时再打开。
      */
 
-    afio_swj_disable_once();
+    //时钟一次打开；每口先写关闭电平再切推挽输出，防止上电误加热
+    pin_cfg_apply(s_heat_pin_cfg, (uint8_t)(sizeof(s_heat_pin_cfg) / sizeof(s_heat_pin_cfg[0])), HEAT_OUT_APB2_CLK);
+    s_heat_state = 0;
 
-    //逐路配置输出 & 默认关闭
-    for(int i = 0; i<HEAT_OUT_NUM; i++)
-    {
-        gpio_config_output_pp_50m(s_heat_map[i].port, s_heat_map[i].pin);
-        
-        //默认关闭，防止上电误加热
-        heat_out_set((heat_out_ch_t)i, 0);
-    }
-     
+    afio_swj_disable_once();
 }
\ No newline at end of file
@@ -0,0 +1,450 @@
+#include "heat_pid.h"
+#include "heat_pwm.h"
+#include "temp_sense.h"
+
+/***************************************************************
+ * 内部类型
+ ***************************************************************/
+
+/**
+ * @brief 继电器自整定（Åström–Hägglund）状态
+ * 输出在 relay 和 0 之间切换：温度 < 设定-回差 开，> 设定+回差 关，
+ * 形成极限环。测出振荡幅值 a 和周期 Tu 后：
+ *   Ku = 4d / (π·a)，d = relay/2
+ *   Ziegler–Nichols：Kp = 0.6Ku，Ki = 1.2Ku/Tu，Kd = 0.075Ku·Tu
+ */
+typedef struct{
+    heat_tune_state_t state;
+    uint16_t relay;         // 继电器高电平输出（‰）
+    int32_t  hyst;          // 回差（0.01℃）
+    uint8_t  relay_on;
+    uint8_t  cycles;        // 已完成的完整振荡周期数
+    int32_t  t_max;         // 本周期最高温
+    int32_t  t_min;         // 本周期最低温
+    int64_t  amp_sum;       // 峰峰值累加（0.01℃）
+    uint32_t period_sum;    // 周期累加（ms）
+    uint32_t last_on_ms;    // 上次继电器由关变开的时刻
+    uint32_t elapsed_ms;
+}heat_tune_t;
+
+typedef struct{
+    heat_pid_mode_t  mode;
+    heat_pid_gains_t gains;
+    uint8_t  heater_mask;
+    int32_t  setpoint;      // 0.01℃
+    int32_t  temp;          // 最近一次测量 0.01℃
+    int32_t  prev_temp;
+    uint8_t  has_prev;
+    int32_t  integ_q16;     // 积分项（‰，Q16）
+    int32_t  d_filt;        // 滤波后的微分项（‰）
+    uint16_t output;        // ‰
+    heat_tune_t tune;
+}heat_pid_zone_t;
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+static heat_pid_zone_t s_zone[HEAT_ZONE_NUM];
+static volatile uint16_t s_period_ms = HEAT_PID_PERIOD_MS_DEFAULT;
+static uint16_t s_tick_ms = 0;
+static uint32_t s_now_ms = 0;
+static volatile uint8_t s_inited = 0;
+
+/**
+ * @brief 默认增益：Kp=40‰/℃，Ki=0.2‰/(℃·s)，Kd=200‰·s/℃，建议用自整定得到实际值
+ */
+static const heat_pid_gains_t s_default_gains = {
+    40 << HEAT_PID_GAIN_SHIFT,
+    (2 << HEAT_PID_GAIN_SHIFT) / 10,
+    200 << HEAT_PID_GAIN_SHIFT
+};
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static int32_t clamp_i32(int32_t v, int32_t lo, int32_t hi)
+{
+    if(v < lo) return lo;
+    if(v > hi) return hi;
+    return v;
+}
+
+/**
+ * @brief 读取温区温度（0.01℃）
+ * @return 1=有效，0=未就绪、NTC短路/断路或数据过期
+ */
+static uint8_t heat_pid_read_temp(heat_zone_t zone, int32_t *temp_centi)
+{
+    temp_sense_reading_t r;
+
+    if(!temp_sense_read((temp_sense_ch_t)(TEMP_SENSE_NTC1 + zone), &r)) return 0;
+
+    *temp_centi = r.temp_centi;
+    return 1;
+}
+
+static void heat_pid_apply(heat_pid_zone_t *z, uint16_t permille)
+{
+    z->output = permille;
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        if(z->heater_mask & (1U << i)) heat_pwm_set_permille((heat_out_ch_t)i, permille);
+    }
+}
+
+static void heat_pid_reset_state(heat_pid_zone_t *z)
+{
+    z->integ_q16 = 0;
+    z->d_filt = 0;
+    z->has_prev = 0;
+}
+
+/**
+ * @brief 一次PID计算（定点）
+ * - 微分作用在测量值上，设定值阶跃不会产生微分冲击
+ * - 抗积分饱和：输出已饱和且误差继续推向饱和方向时停止积分，积分项本身也限幅到 0~1000‰
+ */
+static uint16_t heat_pid_step(heat_pid_zone_t *z, uint16_t dt_ms)
+{
+    const int64_t gain_div = (int64_t)100 << HEAT_PID_GAIN_SHIFT;   // 0.01℃ 与 Q10
+    int32_t err = z->setpoint - z->temp;
+
+    // P
+    int32_t p = (int32_t)(((int64_t)z->gains.kp * err) / gain_div);
+
+    // D：-Kd * d(测量)/dt，一阶低通（1/4）抑制ADC噪声
+    int32_t d = 0;
+    if(z->has_prev && dt_ms != 0)
+    {
+        int32_t dmeas = z->temp - z->prev_temp;
+        d = (int32_t)(-((int64_t)z->gains.kd * dmeas * 1000) / (gain_div * dt_ms));
+    }
+    z->d_filt += (d - z->d_filt) / 4;
+    z->prev_temp = z->temp;
+    z->has_prev = 1;
+
+    // I：增量 = Ki * e * dt，存成 Q16 ‰
+    int32_t di = (int32_t)(((int64_t)z->gains.ki * err * dt_ms * 65536) / (gain_div * 1000));
+    int32_t i_term = z->integ_q16 >> 16;
+    int32_t u_pre = p + i_term + z->d_filt;
+
+    // 上限取当前降额功率上限（风扇故障时 fan_mon 会压低），积分不会在上限之后继续累积
+    int32_t u_max = (int32_t)heat_pwm_get_power_cap();
+    uint8_t sat_hi = (u_pre >= u_max) && (di > 0);
+    uint8_t sat_lo = (u_pre <= 0) && (di < 0);
+    if(!sat_hi && !sat_lo)
+    {
+        z->integ_q16 = z->integ_q16 + di;
+    }
+    z->integ_q16 = clamp_i32(z->integ_q16, 0, u_max << 16);
+
+    int32_t u = p + (z->integ_q16 >> 16) + z->d_filt;
+    return (uint16_t)clamp_i32(u, 0, u_max);
+}
+
+/**
+ * @brief 自整定结束：由平均幅值/周期计算 Z-N 增益
+ */
+static void heat_pid_tune_finish(heat_pid_zone_t *z)
+{
+    heat_tune_t *t = &z->tune;
+    int64_t a = t->amp_sum / (2 * (int64_t)t->cycles);    // 半峰峰值，0.01℃
+    uint32_t tu = t->period_sum / t->cycles;             // ms
+
+    if(a <= 0 || tu == 0)
+    {
+        t->state = HEAT_TUNE_FAILED;
+        return;
+    }
+
+    // Ku = 4d/(πa)，d = relay/2，a 单位 0.01℃ -> ‰/℃（Q10）
+    // = 2*relay*100*1024 / (π*a) = 2*relay*100*1024*10000 / (31416*a)
+    int64_t ku = ((int64_t)t->relay * 2 * 100 * 10000 << HEAT_PID_GAIN_SHIFT) / (31416 * a);
+
+    z->gains.kp = (int32_t)(ku * 6 / 10);
+    z->gains.ki = (int32_t)(ku * 12 * 1000 / (10 * (int64_t)tu));
+    z->gains.kd = (int32_t)(ku * 75 * tu / (1000 * 1000));
+    t->state = HEAT_TUNE_DONE;
+}
+
+/**
+ * @brief 自整定一步：继电器控制 + 峰值/周期测量
+ */
+static uint16_t heat_pid_tune_step(heat_pid_zone_t *z, uint16_t dt_ms)
+{
+    heat_tune_t *t = &z->tune;
+
+    t->elapsed_ms += dt_ms;
+    if(t->elapsed_ms > HEAT_PID_AUTOTUNE_TIMEOUT_MS)
+    {
+        t->state = HEAT_TUNE_FAILED;
+        return 0;
+    }
+
+    if(z->temp > t->t_max) t->t_max = z->temp;
+    if(z->temp < t->t_min) t->t_min = z->temp;
+
+    if(t->relay_on && z->temp > z->setpoint + t->hyst)
+    {
+        t->relay_on = 0;
+    }
+    else if(!t->relay_on && z->temp < z->setpoint - t->hyst)
+    {
+        // 关->开：一个完整周期结束（第一次只作为起点）
+        if(t->last_on_ms != 0)
+        {
+            if(t->cycles < 0xFF) t->cycles++;
+            if(t->cycles > 1)   // 丢弃第一个周期（起始过渡）
+            {
+                t->amp_sum += t->t_max - t->t_min;
+                t->period_sum += s_now_ms - t->last_on_ms;
+            }
+            if(t->cycles > HEAT_PID_AUTOTUNE_CYCLES)
+            {
+                t->cycles -= 1;
+                heat_pid_tune_finish(z);
+                return 0;
+            }
+        }
+        t->last_on_ms = (s_now_ms != 0) ? s_now_ms : 1;
+        t->t_max = z->temp;
+        t->t_min = z->temp;
+        t->relay_on = 1;
+    }
+
+    return t->relay_on ? t->relay : 0;
+}
+
+static void heat_pid_zone_update(heat_pid_zone_t *z, heat_zone_t zone, uint16_t dt_ms)
+{
+    if(z->mode == HEAT_PID_OFF) return;
+
+    if(!heat_pid_read_temp(zone, &z->temp))
+    {
+        // 传感器异常：立即清零输出，自整定也判失败
+        if(z->tune.state == HEAT_TUNE_RUNNING) z->tune.state = HEAT_TUNE_FAILED;
+        z->mode = HEAT_PID_FAULT;
+        heat_pid_reset_state(z);
+        heat_pid_apply(z, 0);
+        return;
+    }
+
+    if(z->mode == HEAT_PID_FAULT)
+    {
+        // 传感器恢复：无扰重新进入闭环
+        z->mode = HEAT_PID_RUN;
+        heat_pid_reset_state(z);
+    }
+
+    if(z->mode == HEAT_PID_TUNE)
+    {
+        uint16_t u = heat_pid_tune_step(z, dt_ms);
+        if(z->tune.state == HEAT_TUNE_RUNNING)
+        {
+            heat_pid_apply(z, u);
+            return;
+        }
+        // 整定结束（成功用新增益，失败保持原增益）转入闭环
+        z->mode = HEAT_PID_RUN;
+        heat_pid_reset_state(z);
+    }
+
+    heat_pid_apply(z, heat_pid_step(z, dt_ms));
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化温控：所有温区关闭、默认增益、默认加热通道分组
+ * @note  输出通过 heat_pwm，需先调用 heat_pwm_init；温度来自 temp_sense（这里顺带启动）
+ */
+void heat_pid_init(void)
+{
+    s_inited = 0;
+    temp_sense_init();
+    for(int i = 0; i < HEAT_ZONE_NUM; i++)
+    {
+        s_zone[i] = (heat_pid_zone_t){0};
+        s_zone[i].mode = HEAT_PID_OFF;
+        s_zone[i].gains = s_default_gains;
+    }
+    s_zone[HEAT_ZONE1].heater_mask = 0x0F;  // HEAT1~4
+    s_zone[HEAT_ZONE2].heater_mask = 0xF0;  // HEAT5~8
+    s_tick_ms = 0;
+    s_inited = 1;
+}
+
+_Static_assert(HEAT_PID_PERIOD_MS_DEFAULT >= HEAT_PID_PERIOD_MS_MIN, "guard must respond within one PID period");
+
+/**
+ * @brief 设置控制周期，低于 HEAT_PID_PERIOD_MS_MIN 按下限
+ */
+void heat_pid_set_period_ms(uint16_t period_ms)
+{
+    if(period_ms < HEAT_PID_PERIOD_MS_MIN) period_ms = HEAT_PID_PERIOD_MS_MIN;
+    s_period_ms = period_ms;
+}
+
+uint16_t heat_pid_get_period_ms(void)
+{
+    return s_period_ms;
+}
+
+void heat_pid_set_gains(heat_zone_t zone, const heat_pid_gains_t *gains)
+{
+    if(zone >= HEAT_ZONE_NUM || gains == 0) return;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s_zone[zone].gains = *gains;
+    __set_PRIMASK(primask);
+}
+
+void heat_pid_get_gains(heat_zone_t zone, heat_pid_gains_t *gains)
+{
+    if(zone >= HEAT_ZONE_NUM || gains == 0) return;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    *gains = s_zone[zone].gains;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 修改温区驱动的加热通道，移出的通道功率清零
+ */
+void heat_pid_set_heaters(heat_zone_t zone, uint8_t heater_mask)
+{
+    if(zone >= HEAT_ZONE_NUM) return;
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint8_t removed = s_zone[zone].heater_mask & (uint8_t)~heater_mask;
+    s_zone[zone].heater_mask = heater_mask;
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        if(removed & (1U << i)) heat_pwm_set_permille((heat_out_ch_t)i, 0);
+    }
+    __set_PRIMASK(primask);
+}
+
+void heat_pid_set_setpoint(heat_zone_t zone, int32_t setpoint_centi)
+{
+    if(zone >= HEAT_ZONE_NUM) return;
+    s_zone[zone].setpoint = setpoint_centi;
+}
+
+/**
+ * @brief 打开/关闭温区闭环，关闭时该温区输出清零
+ */
+void heat_pid_enable(heat_zone_t zone, uint8_t on)
+{
+    if(zone >= HEAT_ZONE_NUM) return;
+    heat_pid_zone_t *z = &s_zone[zone];
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(on)
+    {
+        if(z->mode == HEAT_PID_OFF)
+        {
+            heat_pid_reset_state(z);
+            z->mode = HEAT_PID_RUN;
+        }
+    }
+    else
+    {
+        if(z->tune.state == HEAT_TUNE_RUNNING) z->tune.state = HEAT_TUNE_IDLE;
+        z->mode = HEAT_PID_OFF;
+        heat_pid_apply(z, 0);
+    }
+    __set_PRIMASK(primask);
+}
+
+heat_pid_mode_t heat_pid_get_mode(heat_zone_t zone)
+{
+    if(zone >= HEAT_ZONE_NUM) return HEAT_PID_OFF;
+    return s_zone[zone].mode;
+}
+
+int32_t heat_pid_get_temp(heat_zone_t zone)
+{
+    if(zone >= HEAT_ZONE_NUM) return 0;
+    return s_zone[zone].temp;
+}
+
+uint16_t heat_pid_get_output(heat_zone_t zone)
+{
+    if(zone >= HEAT_ZONE_NUM) return 0;
+    return s_zone[zone].output;
+}
+
+/**
+ * @brief 启动继电器自整定
+ * @param setpoint_centi 整定温度（0.01℃），结束后以此为设定值进入闭环
+ * @param relay_permille 继电器开时的输出（‰），幅度越大振荡越明显
+ * @param hyst_centi     回差（0.01℃），应大于测量噪声
+ * @return 1=已启动，0=参数错误
+ */
+uint8_t heat_pid_autotune_start(heat_zone_t zone, int32_t setpoint_centi,
+                                uint16_t relay_permille, int32_t hyst_centi)
+{
+    if(zone >= HEAT_ZONE_NUM || relay_permille == 0 || hyst_centi < 0) return 0;
+    if(relay_permille > HEAT_PWM_PERMILLE_MAX) relay_permille = HEAT_PWM_PERMILLE_MAX;
+
+    heat_pid_zone_t *z = &s_zone[zone];
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    z->tune = (heat_tune_t){0};
+    z->tune.state = HEAT_TUNE_RUNNING;
+    z->tune.relay = relay_permille;
+    z->tune.hyst = hyst_centi;
+    z->setpoint = setpoint_centi;
+    heat_pid_reset_state(z);
+    z->mode = HEAT_PID_TUNE;
+    __set_PRIMASK(primask);
+    return 1;
+}
+
+void heat_pid_autotune_abort(heat_zone_t zone)
+{
+    if(zone >= HEAT_ZONE_NUM) return;
+    heat_pid_zone_t *z = &s_zone[zone];
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if(z->tune.state == HEAT_TUNE_RUNNING)
+    {
+        z->tune.state = HEAT_TUNE_IDLE;
+        z->mode = HEAT_PID_OFF;
+        heat_pid_apply(z, 0);
+    }
+    __set_PRIMASK(primask);
+}
+
+heat_tune_state_t heat_pid_autotune_state(heat_zone_t zone)
+{
+    if(zone >= HEAT_ZONE_NUM) return HEAT_TUNE_IDLE;
+    return s_zone[zone].tune.state;
+}
+
+/**
+ * @brief 1ms节拍（SysTick中断），每个控制周期计算一次所有温区
+ */
+void heat_pid_tick_1ms(void)
+{
+    if(!s_inited) return;
+
+    s_now_ms++;
+    if(++s_tick_ms < s_period_ms) return;
+
+    uint16_t dt = s_tick_ms;
+    s_tick_ms = 0;
+
+    for(int i = 0; i < HEAT_ZONE_NUM; i++)
+    {
+        heat_pid_zone_update(&s_zone[i], (heat_zone_t)i, dt);
+    }
+}
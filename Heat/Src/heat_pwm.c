@@ -0,0 +1,408 @@
+#include "heat_pwm.h"
+#include "adc_frame.h"
+
+/***************************************************************
+ * 内部状态
+ ***************************************************************/
+
+/**
+ * @brief 每路功率设定（千分比 0~1000）
+ * 上层随时可写，但只在周期起点被锁存成 on_ticks，
+ * 这样一个周期内的开/关窗口不会被中途改动打乱。
+ */
+static volatile uint16_t s_permille[HEAT_OUT_NUM];
+
+static uint16_t s_on_ticks[HEAT_OUT_NUM];   // 本周期每路打开的节拍数
+static uint16_t s_start_ticks[HEAT_OUT_NUM];// 本周期每路打开窗口的起点（错峰）
+static volatile uint16_t s_period_ticks_req = HEAT_PWM_PERIOD_MS_DEFAULT / HEAT_PWM_TICK_MS;
+static uint16_t s_period_ticks = HEAT_PWM_PERIOD_MS_DEFAULT / HEAT_PWM_TICK_MS;
+static uint16_t s_phase = 0;                // 当前周期内的节拍位置
+static uint8_t  s_out_state = 0;            // 当前已输出的开关状态（bit i = 第 i 路）
+static volatile uint8_t s_running = 0;
+static volatile heat_pwm_mode_t s_mode = HEAT_PWM_MODE_SLOW_PWM;
+
+/**
+ * @brief Σ-Δ（Bresenham）调制状态
+ * 每个基准节拍每路累加器 += 设定‰，满 1000 则本节拍打开并减 1000，
+ * 开/关节拍在任意占空比下都尽量均匀交错。
+ */
+static uint16_t s_sd_acc[HEAT_OUT_NUM];
+static volatile uint16_t s_sd_base_ticks = HEAT_PWM_SD_BASE_MS_DEFAULT / HEAT_PWM_TICK_MS;
+static uint16_t s_sd_div = 0;
+static uint8_t  s_sd_rr = 0;                // 放行轮转起点，超过同时导通上限时轮流让路
+
+/**
+ * @brief 错峰调度与电流核验
+ */
+static volatile uint8_t  s_max_on = HEAT_PWM_MAX_ON_DEFAULT;  // 同时导通路数上限
+static volatile uint8_t  s_overload = 0;        // 本周期总功率超过上限，已按比例压缩
+static volatile uint16_t s_peak_cur = 0;        // 上一周期实测热控总电流峰值（ADC原始值）
+static volatile uint16_t s_peak_cur_acc = 0;    // 本周期峰值累计
+static volatile uint32_t s_overcur_cnt = 0;     // 实测峰值超过上限的周期数
+static volatile uint16_t s_power_cap = HEAT_PWM_PERMILLE_MAX;  // 降额：每路功率上限（‰）
+
+/***************************************************************
+ * 内部工具函数
+ ***************************************************************/
+
+static uint16_t heat_pwm_clamp_period(uint16_t period_ms)
+{
+    if(period_ms < HEAT_PWM_PERIOD_MS_MIN) period_ms = HEAT_PWM_PERIOD_MS_MIN;
+    if(period_ms > HEAT_PWM_PERIOD_MS_MAX) period_ms = HEAT_PWM_PERIOD_MS_MAX;
+    return period_ms;
+}
+
+/**
+ * @brief 某一路实际执行的功率：设定值与降额上限取小
+ */
+static uint16_t heat_pwm_eff_permille(int ch)
+{
+    uint16_t p = s_permille[ch];
+    uint16_t cap = s_power_cap;
+    return (p < cap) ? p : cap;
+}
+
+/**
+ * @brief 周期起点：锁存新周期长度和各路打开节拍数，并排出错峰起点
+ *
+ * 错峰方法（McNaughton 环绕排列）：
+ * 把各路打开窗口首尾相接排在一条长度为 N*周期 的时间线上，
+ * 第 k 段周期长的时间线就是第 k 条“导通车道”，再折回到一个周期内。
+ * 跨车道边界的窗口折回后变成“周期尾 + 周期头”两段，两段不重叠。
+ * 因此同一时刻最多导通 ceil(总打开节拍/周期) 路，且每路的打开节拍数不变，
+ * 平均占空比精确保持。
+ * 若总打开节拍超过 上限*周期，按比例压缩所有通道（供电能力优先），并置过载标志。
+ */
+static void heat_pwm_latch(void)
+{
+    uint32_t total = 0;
+    uint32_t cap;
+
+    s_period_ticks = s_period_ticks_req;
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        s_on_ticks[i] = (uint16_t)(((uint32_t)heat_pwm_eff_permille(i) * s_period_ticks + HEAT_PWM_PERMILLE_MAX / 2U)
+                                   / HEAT_PWM_PERMILLE_MAX);
+        total += s_on_ticks[i];
+    }
+
+    cap = (uint32_t)s_max_on * s_period_ticks;
+    s_overload = (total > cap);
+    if(s_overload)
+    {
+        for(int i = 0; i < HEAT_OUT_NUM; i++)
+        {
+            s_on_ticks[i] = (uint16_t)((uint32_t)s_on_ticks[i] * cap / total);
+        }
+    }
+
+    uint32_t pos = 0;
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        s_start_ticks[i] = (uint16_t)(pos % s_period_ticks);
+        pos += s_on_ticks[i];
+    }
+}
+
+/**
+ * @brief 当前节拍某一路是否处于打开窗口（窗口可跨周期末尾环绕）
+ */
+static uint8_t heat_pwm_is_on(int ch)
+{
+    uint16_t rel = (s_phase >= s_start_ticks[ch])
+                 ? (uint16_t)(s_phase - s_start_ticks[ch])
+                 : (uint16_t)(s_phase + s_period_ticks - s_start_ticks[ch]);
+    return rel < s_on_ticks[ch];
+}
+
+/**
+ * @brief Σ-Δ 累加器初值错开 1000/8，减少各路在同一节拍同时打开
+ */
+static void heat_pwm_sd_reset(void)
+{
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        s_sd_acc[i] = (uint16_t)(i * HEAT_PWM_PERMILLE_MAX / HEAT_OUT_NUM);
+    }
+    s_sd_div = 0;
+    s_sd_rr = 0;
+}
+
+/**
+ * @brief Σ-Δ 一个基准节拍：8路一起判定，按端口合并成 BSRR 写
+ * @note  与慢速PWM共用同时导通上限：累加器满的通道从轮转起点依次放行，最多 s_max_on 路，
+ *        没轮到的保留累加值下一节拍再争；持续超限时累加值封顶，等效按比例压缩并置过载标志
+ */
+static void heat_pwm_sd_step(void)
+{
+    uint32_t total = 0;
+    uint8_t want = 0, n = 0;
+
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        uint16_t p = heat_pwm_eff_permille(i);
+
+        total += p;
+        s_sd_acc[i] += p;
+        if(s_sd_acc[i] > 2U * HEAT_PWM_PERMILLE_MAX) s_sd_acc[i] = 2U * HEAT_PWM_PERMILLE_MAX;
+    }
+    s_overload = (total > (uint32_t)s_max_on * HEAT_PWM_PERMILLE_MAX);
+
+    for(int k = 0; k < HEAT_OUT_NUM && n < s_max_on; k++)
+    {
+        int i = (s_sd_rr + k) % HEAT_OUT_NUM;
+
+        if(s_sd_acc[i] >= HEAT_PWM_PERMILLE_MAX)
+        {
+            s_sd_acc[i] -= HEAT_PWM_PERMILLE_MAX;
+            want |= (uint8_t)(1U << i);
+            n++;
+        }
+    }
+    s_sd_rr = (uint8_t)((s_sd_rr + 1U) % HEAT_OUT_NUM);
+
+    if(want == s_out_state) return;
+
+    // 先关后开，与慢速PWM相同
+    uint8_t keep = want & s_out_state;
+    if(keep != s_out_state) heat_out_set_mask(keep);
+    if(keep != want)        heat_out_set_mask(want);
+    s_out_state = want;
+}
+
+/**
+ * @brief 慢速PWM一个节拍：按错峰窗口判定，状态有变化时按端口批量写
+ */
+static void heat_pwm_slow_step(void)
+{
+    if(s_phase == 0) heat_pwm_latch();
+
+    uint8_t want = 0;
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        if(heat_pwm_is_on(i)) want |= (uint8_t)(1U << i);
+    }
+
+    if(want == s_out_state) return;
+
+    // 先关后开：同时导通路数在切换瞬间也不超过上限
+    uint8_t keep = want & s_out_state;
+    if(keep != s_out_state) heat_out_set_mask(keep);
+    if(keep != want)        heat_out_set_mask(want);
+    s_out_state = want;
+}
+
+/**
+ * @brief ADC帧回调：记录本周期热控总电流峰值（HEAT_CURRENT1 + HEAT_CURRENT2）
+ */
+static void heat_pwm_on_adc_frame(const uint16_t *frame)
+{
+    uint16_t sum = (uint16_t)(frame[ADC_FRAME_HEAT_CURRENT1] + frame[ADC_FRAME_HEAT_CURRENT2]);
+    if(sum > s_peak_cur_acc) s_peak_cur_acc = sum;
+}
+
+/**
+ * @brief 周期结束：核验实测峰值是否超过 上限路数*单路额定电流*余量
+ */
+static void heat_pwm_check_current(void)
+{
+    uint32_t limit = (uint32_t)s_max_on * HEAT_PWM_HEATER_CURRENT_RAW * HEAT_PWM_CURRENT_MARGIN_PCT / 100U;
+
+    s_peak_cur = s_peak_cur_acc;
+    s_peak_cur_acc = 0;
+    if(s_peak_cur > limit) s_overcur_cnt++;
+}
+
+/***************************************************************
+ * 对外接口
+ ***************************************************************/
+
+/**
+ * @brief 初始化慢速PWM，所有通道功率清零
+ * @param period_ms 时间比例周期（毫秒）
+ * @note  需先调用 heat_out_init_register 完成IO初始化
+ */
+void heat_pwm_init(uint16_t period_ms)
+{
+    s_running = 0;
+
+    for(int i = 0; i < HEAT_OUT_NUM; i++)
+    {
+        s_permille[i] = 0;
+        heat_out_set((heat_out_ch_t)i, 0);
+    }
+    s_out_state = 0;
+
+    s_period_ticks_req = heat_pwm_clamp_period(period_ms) / HEAT_PWM_TICK_MS;
+    s_phase = 0;
+    heat_pwm_latch();
+    heat_pwm_sd_reset();
+
+    adc_frame_register_hook(heat_pwm_on_adc_frame);
+    s_running = 1;
+}
+
+/**
+ * @brief 修改时间比例周期，下一个周期起生效
+ */
+void heat_pwm_set_period(uint16_t period_ms)
+{
+    s_period_ticks_req = heat_pwm_clamp_period(period_ms) / HEAT_PWM_TICK_MS;
+}
+
+uint16_t heat_pwm_get_period(void)
+{
+    return (uint16_t)(s_period_ticks_req * HEAT_PWM_TICK_MS);
+}
+
+/**
+ * @brief 设置某一路功率（千分比），下一个周期起生效
+ */
+void heat_pwm_set_permille(heat_out_ch_t ch, uint16_t permille)
+{
+    if(ch >= HEAT_OUT_NUM) return;
+    if(permille > HEAT_PWM_PERMILLE_MAX) permille = HEAT_PWM_PERMILLE_MAX;
+    s_permille[ch] = permille;
+}
+
+uint16_t heat_pwm_get_permille(heat_out_ch_t ch)
+{
+    if(ch >= HEAT_OUT_NUM) return 0;
+    return s_permille[ch];
+}
+
+/**
+ * @brief 各路设定值数组的只读视图（HEAT_OUT_NUM 个，供寄存器映射零拷贝读取）
+ */
+const volatile uint16_t *heat_pwm_permille_table(void)
+{
+    return s_permille;
+}
+
+/**
+ * @brief 降额：所有通道的实际功率不超过 cap_permille（设定值保留，解除后恢复）
+ * @note  散热失效等场合由保护模块调用，单次写，可在中断里调用；下一个周期/Σ-Δ节拍起生效
+ */
+void heat_pwm_set_power_cap(uint16_t cap_permille)
+{
+    if(cap_permille > HEAT_PWM_PERMILLE_MAX) cap_permille = HEAT_PWM_PERMILLE_MAX;
+    s_power_cap = cap_permille;
+}
+
+uint16_t heat_pwm_get_power_cap(void)
+{
+    return s_power_cap;
+}
+
+/**
+ * @brief 设置同时导通路数上限（1~HEAT_OUT_NUM），下一个周期起生效
+ */
+void heat_pwm_set_max_on(uint8_t max_on)
+{
+    if(max_on < 1) max_on = 1;
+    if(max_on > HEAT_OUT_NUM) max_on = HEAT_OUT_NUM;
+    s_max_on = max_on;
+}
+
+uint8_t heat_pwm_get_max_on(void)
+{
+    return s_max_on;
+}
+
+/**
+ * @brief 按当前设定每路最多能放行的占空比：降额上限，再按错峰压缩比例折算
+ * @note  供热保护判断“是否在满力加热”，各路设定都已到上限时等于实际导通占空比
+ */
+uint16_t heat_pwm_get_allowed_permille(void)
+{
+    uint32_t total = 0;
+    uint32_t limit = (uint32_t)s_max_on * HEAT_PWM_PERMILLE_MAX;
+    uint16_t cap = s_power_cap;
+
+    for(int i = 0; i < HEAT_OUT_NUM; i++) total += heat_pwm_eff_permille(i);
+    if(total <= limit) return cap;
+    return (uint16_t)((uint32_t)cap * limit / total);
+}
+
+/**
+ * @brief 本周期设定总功率是否超过上限（已按比例压缩）
+ */
+uint8_t heat_pwm_is_overloaded(void)
+{
+    return s_overload;
+}
+
+/**
+ * @brief 上一周期实测热控总电流峰值（HEAT_CURRENT1+2 的ADC原始值之和）
+ */
+uint16_t heat_pwm_get_peak_current_raw(void)
+{
+    return s_peak_cur;
+}
+
+/**
+ * @brief 实测峰值超过 上限路数*单路额定电流 的累计周期数
+ */
+uint32_t heat_pwm_get_overcurrent_count(void)
+{
+    return s_overcur_cnt;
+}
+
+/**
+ * @brief 切换调制方式：慢速PWM（固定周期、错峰窗口）或 Σ-Δ（逐节拍均匀分布）
+ * @note  切换后从新周期开始
+ */
+void heat_pwm_set_mode(heat_pwm_mode_t mode)
+{
+    if(mode != HEAT_PWM_MODE_SLOW_PWM && mode != HEAT_PWM_MODE_SIGMA_DELTA) return;
+
+    uint8_t running = s_running;
+    s_running = 0;
+    s_mode = mode;
+    s_phase = 0;
+    heat_pwm_sd_reset();
+    s_running = running;
+}
+
+heat_pwm_mode_t heat_pwm_get_mode(void)
+{
+    return s_mode;
+}
+
+/**
+ * @brief 设置 Σ-Δ 判定间隔（毫秒，>=1），即单次打开/关闭的最短时间
+ */
+void heat_pwm_set_sd_base_ms(uint16_t base_ms)
+{
+    if(base_ms < HEAT_PWM_TICK_MS) base_ms = HEAT_PWM_TICK_MS;
+    s_sd_base_ticks = base_ms / HEAT_PWM_TICK_MS;
+}
+
+/**
+ * @brief 调制节拍，每 HEAT_PWM_TICK_MS 调用一次（SysTick中断）
+ * @note  慢速PWM：只有状态变化的通道才写 BSRR/BRR；先关后开，
+ *        错峰交接的两路不会在同一节拍里短暂叠加。
+ *        Σ-Δ：每 s_sd_base_ticks 判定一次。
+ *        两种方式都以 周期 为窗口核验热控电流峰值。
+ */
+void heat_pwm_tick(void)
+{
+    if(!s_running) return;
+
+    if(s_phase == 0) heat_pwm_check_current();
+
+    if(s_mode == HEAT_PWM_MODE_SIGMA_DELTA)
+    {
+        if(++s_sd_div >= s_sd_base_ticks)
+        {
+            s_sd_div = 0;
+            heat_pwm_sd_step();
+        }
+    }
+    else
+    {
+        heat_pwm_slow_step();
+    }
+
+    if(++s_phase >= s_period_ticks) s_phase = 0;
+}
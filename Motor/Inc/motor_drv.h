@@ -63,6 +63,13 @@ void motor_drv_reverse(motor_id_t id);
  */
 void motor_drv_stop(motor_id_t id);
 
+/**
+ * @brief  获取电机当前指令方向
+ * @param  id: 电机ID
+ * @retval 当前方向
+ */
+motor_dir_t motor_drv_get_dir(motor_id_t id);
+
 /******************************************************************************
  *                          霍尔传感器函数声明
  ******************************************************************************/
@@ -98,6 +105,26 @@ void motor_drv_hall_enable(void);          // 打开霍尔模块
 void motor_drv_hall_disable(void);         // 关闭霍尔模块
 uint8_t motor_drv_hall_is_enabled(void);   // 查询当前开关状态
 
+/**
+ * @brief  获取指定电机的位置计数（霍尔关闭时为纹波估计值）
+ * @param  id: 电机ID
+ * @retval 与 motor_drv_hall_get_count 同口径的计数值
+ */
+uint32_t motor_drv_pos_get_count(motor_id_t id);
+
+/**
+ * @brief  获取位置计数置信度
+ * @param  id: 电机ID
+ * @retval 0~100，霍尔打开时恒为100
+ */
+uint8_t motor_drv_pos_get_confidence(motor_id_t id);
+
+/**
+ * @brief  运行方向数组的只读视图（MOTOR_NUM 个元素，供寄存器映射零拷贝读取）
+ * @retval 模块内部数组首地址，单个元素读取是原子的
+ */
+const volatile motor_dir_t *motor_drv_dir_table(void);
+
 
 /******************************************************************************
  *                          电机采集电流函数声明
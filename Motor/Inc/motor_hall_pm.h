@@ -0,0 +1,62 @@
+#ifndef __MOTOR_HALL_PM_H__
+#define __MOTOR_HALL_PM_H__
+
+#include "stm32f1xx_hal.h"
+#include "hardware_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *                              配置参数
+ ******************************************************************************/
+
+/* 默认空闲断电时间：所有电机停止持续这么久后关闭霍尔供电 */
+#define MOTOR_HALL_PM_IDLE_OFF_MS_DEFAULT   30000U
+
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+
+/**
+ * @brief  启用霍尔自动供电管理
+ * @param  idle_off_ms: 所有电机停止多久后断电，0=永不自动断电
+ * @note   调用后霍尔立即上电，空闲计时从0开始
+ * @retval None
+ */
+void motor_hall_pm_init(uint32_t idle_off_ms);
+
+/**
+ * @brief  运行时修改空闲断电时间
+ * @param  idle_off_ms: 毫秒，0=永不自动断电
+ * @retval None
+ */
+void motor_hall_pm_set_idle_off_ms(uint32_t idle_off_ms);
+
+/**
+ * @brief  预唤醒：上层已知即将下发运动指令时提前调用
+ * @note   霍尔立即上电并重置空闲计时；至少提前 HALL_EN_SETTLE_MS 调用，
+ *         则运动开始时霍尔已稳定，全程使用真实霍尔计数
+ * @retval None
+ */
+void motor_hall_pm_prewake(void);
+
+/**
+ * @brief  运动开始通知，由 motor_drv_set_dir 在电机由停止转为运动时调用
+ * @note   不阻塞：霍尔若已断电则立即上电，稳定前由纹波估计提供位置
+ * @retval None
+ */
+void motor_hall_pm_notify_motion(void);
+
+/**
+ * @brief  1ms 节拍，在 SysTick 中断中调用
+ * @retval None
+ */
+void motor_hall_pm_tick_1ms(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOTOR_HALL_PM_H__ */
@@ -0,0 +1,73 @@
+#ifndef __MOTOR_RIPPLE_H__
+#define __MOTOR_RIPPLE_H__
+
+#include "stm32f1xx_hal.h"
+#include "hardware_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/******************************************************************************
+ *                              配置参数
+ ******************************************************************************/
+
+/* 电机每转一圈的换向纹波个数（= 换向片数，按实际电机修改） */
+#define MOTOR_RIPPLE_PER_REV            12U
+/* 电机每转一圈的霍尔计数（与 motor_drv_hall_get_count 的计数口径一致） */
+#define MOTOR_RIPPLE_HALL_EDGES_PER_REV 1U
+
+/* 均值(直流分量)跟踪系数：1/2^6，截止频率约 ADC_FRAME_RATE_HZ/400 */
+#define MOTOR_RIPPLE_DC_SHIFT           6U
+/* 平滑低通系数：1/2^1，滤掉ADC量化噪声，保留纹波 */
+#define MOTOR_RIPPLE_LP_SHIFT           1U
+/* 幅值包络跟踪系数：1/2^5 */
+#define MOTOR_RIPPLE_ENV_SHIFT          5U
+
+/* 电流均值低于该原始值视为电机未通电，不计数 */
+#define MOTOR_RIPPLE_MIN_CURRENT_RAW    40U
+/* 纹波包络低于该原始值视为噪声，不计数 */
+#define MOTOR_RIPPLE_MIN_AMPLITUDE_RAW  3U
+/* 两个纹波之间的最少采样帧数（消抖，限定最高可测纹波频率） */
+#define MOTOR_RIPPLE_MIN_PERIOD         2U
+/* 运行中超过该帧数没检测到纹波，则置信度清零（堵转/漏检） */
+#define MOTOR_RIPPLE_MAX_PERIOD         400U
+
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+
+/**
+ * @brief  纹波计数估计器初始化，并挂到 ADC 帧流上
+ * @note   需在 adc_frame_init 之后调用
+ * @retval None
+ */
+void motor_ripple_init(void);
+
+/**
+ * @brief  以指定霍尔计数作为估计起点
+ * @param  id: 电机ID
+ * @param  hall_count: 起始计数（通常是关闭霍尔前的最后计数值）
+ * @retval None
+ */
+void motor_ripple_seed(motor_id_t id, uint32_t hall_count);
+
+/**
+ * @brief  获取估计的霍尔计数
+ * @param  id: 电机ID
+ * @retval 与 motor_drv_hall_get_count 同口径的估计计数，越界返回0
+ */
+uint32_t motor_ripple_get_count(motor_id_t id);
+
+/**
+ * @brief  获取估计置信度
+ * @param  id: 电机ID
+ * @retval 0~100，综合纹波幅值信噪比与周期一致性；越界返回0
+ */
+uint8_t motor_ripple_get_confidence(motor_id_t id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MOTOR_RIPPLE_H__ */
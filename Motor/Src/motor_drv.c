@@ -1,4 +1,8 @@
 #include "motor_drv.h"
+#include "motor_ripple.h"
+#include "motor_hall_pm.h"
+#include "adc_frame.h"
+#include "pin_cfg.h"
 #include "stm32f103xe.h"
 
 /******************************************************************************
@@ -36,27 +40,62 @@ static const motor_gpio_t motor_map[MOTOR_NUM] =
     {MOTOR6_FWD_PORT, MOTOR6_FWD_PIN, MOTOR6_REV_PORT, MOTOR6_REV_PIN},
 };
 
+/**
+ * @brief 12路电机方向输出清单，供编译期生成端口表：F(端口, 引脚, 目标端口, a, b)
+ */
+#define MOTOR_OUT_PINS(F, gpio, a, b) ( \
+    F(MOTOR1_FWD_PORT, MOTOR1_FWD_PIN, gpio, a, b) | F(MOTOR1_REV_PORT, MOTOR1_REV_PIN, gpio, a, b) | \
+    F(MOTOR2_FWD_PORT, MOTOR2_FWD_PIN, gpio, a, b) | F(MOTOR2_REV_PORT, MOTOR2_REV_PIN, gpio, a, b) | \
+    F(MOTOR3_FWD_PORT, MOTOR3_FWD_PIN, gpio, a, b) | F(MOTOR3_REV_PORT, MOTOR3_REV_PIN, gpio, a, b) | \
+    F(MOTOR4_FWD_PORT, MOTOR4_FWD_PIN, gpio, a, b) | F(MOTOR4_REV_PORT, MOTOR4_REV_PIN, gpio, a, b) | \
+    F(MOTOR5_FWD_PORT, MOTOR5_FWD_PIN, gpio, a, b) | F(MOTOR5_REV_PORT, MOTOR5_REV_PIN, gpio, a, b) | \
+    F(MOTOR6_FWD_PORT, MOTOR6_FWD_PIN, gpio, a, b) | F(MOTOR6_REV_PORT, MOTOR6_REV_PIN, gpio, a, b) )
+
+/**
+ * @brief 电机输出端口配置表（编译期生成）
+ * @note  推挽输出 2MHz（与 CubeMX 生成的 MOTOR1 配置一致），配置前先全部拉低 = 停止
+ */
+#define MOTOR_OUT_PORT(gpio) \
+    PIN_CFG_PORT(MOTOR_OUT_PINS, gpio, PIN_CFG_OUT_PP_2M, MOTOR_OUT_PINS(PIN_CFG_PIN_OF, gpio, 0, 0) << 16)
+
+static const pin_cfg_port_t motor_pin_cfg[] =
+{
+    MOTOR_OUT_PORT(GPIOA),
+    MOTOR_OUT_PORT(GPIOB),
+    MOTOR_OUT_PORT(GPIOC),
+    MOTOR_OUT_PORT(GPIOD),
+};
+
 /**
  * @brief 霍尔传感器脉冲计数数组
  * @note  每个电机对应一个计数器，在中断中累加
  */
 static volatile uint32_t s_hall_cnt[MOTOR_NUM] = {0};
 
+/**
+ * @brief 电机当前指令方向
+ * @note  纹波估计器据此判断电机是否在运行
+ */
+static volatile motor_dir_t s_motor_dir[MOTOR_NUM] = {MOTOR_DIR_STOP};
+
 /******************************************************************************
  *                           电机方向控制函数
  ******************************************************************************/
 
 /**
  * @brief  电机驱动初始化
- * @note   将所有电机设置为停止状态（正反转引脚均拉低）
+ * @note   配置全部12路方向输出并设置为停止状态（正反转引脚均拉低），
+ *         每个端口先写一次 BSRR 再各写一次 CRL/CRH
  * @retval None
  */
 void motor_drv_init(void)
 {
+    pin_cfg_apply(motor_pin_cfg, (uint8_t)(sizeof(motor_pin_cfg) / sizeof(motor_pin_cfg[0])),
+                  MOTOR_OUT_PINS(PIN_CFG_CLK_OF, 0, 0, 0));
+
     for (int i = 0; i < MOTOR_NUM; i++)
     {
-        HAL_GPIO_WritePin(motor_map[i].fwd_port, motor_map[i].fwd_pin, GPIO_PIN_RESET);
-        HAL_GPIO_WritePin(motor_map[i].rev_port, motor_map[i].rev_pin, GPIO_PIN_RESET);
+        s_motor_dir[i] = MOTOR_DIR_STOP;
     }
 }
 
@@ -74,6 +113,12 @@ void motor_drv_set_dir(motor_id_t id, motor_dir_t dir)
         return;
     }
 
+    // 从停止到运动：霍尔若已断电则立即上电（不等待，稳定前由纹波估计接管位置）
+    if (dir != MOTOR_DIR_STOP && s_motor_dir[id] == MOTOR_DIR_STOP)
+    {
+        motor_hall_pm_notify_motion();
+    }
+
     switch (dir) 
     {
         case MOTOR_DIR_STOP:
@@ -92,8 +137,24 @@ void motor_drv_set_dir(motor_id_t id, motor_dir_t dir)
             break;
 
         default:
-            break;
+            return;
+    }
+
+    s_motor_dir[id] = dir;
+}
+
+/**
+ * @brief  获取电机当前指令方向
+ * @param  id: 电机ID
+ * @retval 当前方向，越界返回 MOTOR_DIR_STOP
+ */
+motor_dir_t motor_drv_get_dir(motor_id_t id)
+{
+    if (id >= MOTOR_NUM) 
+    {
+        return MOTOR_DIR_STOP;
     }
+    return s_motor_dir[id];
 }
 
 /**
@@ -140,6 +201,7 @@ void motor_drv_hall_init(void)
     for (int i = 0; i < MOTOR_NUM; i++)
     {
         s_hall_cnt[i] = 0;
+        motor_ripple_seed((motor_id_t)i, 0);
     }
 }
 
@@ -157,6 +219,11 @@ uint32_t motor_drv_hall_get_count(motor_id_t id)
     return s_hall_cnt[id];
 }
 
+const volatile motor_dir_t *motor_drv_dir_table(void)
+{
+    return s_motor_dir;
+}
+
 /**
  * @brief  清零指定电机的霍尔计数值
  * @param  id: 电机ID
@@ -169,6 +236,7 @@ void motor_drv_hall_clear(motor_id_t id)
         return;
     }
     s_hall_cnt[id] = 0;
+    motor_ripple_seed(id, 0);
 }
 
 /**
@@ -180,6 +248,7 @@ void motor_drv_hall_clear_all(void)
     for (int i = 0; i < MOTOR_NUM; i++)
     {
         s_hall_cnt[i] = 0;
+        motor_ripple_seed((motor_id_t)i, 0);
     }
 }
 
@@ -190,15 +259,58 @@ void motor_drv_hall_clear_all(void)
  *==============================================================*/
 
 static uint8_t s_hall_enabled = 0;  // 记录当前霍尔是否已经使能
+static volatile uint8_t s_hall_adopt_pending = 0;  // 上电稳定后需要从纹波估计接续计数
+static volatile uint32_t s_hall_on_tick = 0;       // 最近一次上电的时刻(ms)
+
+/**
+ * @brief 霍尔上电稳定检查：稳定时间已过则把纹波估计值接续到霍尔计数
+ * @note  在 EXTI 回调和读计数接口中调用，无需额外定时器
+ */
+static void hall_settle_check(void)
+{
+    if (!s_hall_adopt_pending || (HAL_GetTick() - s_hall_on_tick) < HALL_EN_SETTLE_MS)
+    {
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (s_hall_adopt_pending)
+    {
+        for (int i = 0; i < MOTOR_NUM; i++)
+        {
+            s_hall_cnt[i] = motor_ripple_get_count((motor_id_t)i);
+        }
+        s_hall_adopt_pending = 0;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief 霍尔是否处于上电稳定期（输出尚不可信）
+ */
+static uint8_t hall_is_settling(void)
+{
+    hall_settle_check();
+    return s_hall_adopt_pending;
+}
 
 
 /**
  * @brief 打开霍尔模块公共使能（HALL_EN）输出。
+ * @note  不阻塞。若之前处于关闭状态，HALL_EN_SETTLE_MS 内的霍尔边沿不计数，
+ *        稳定后霍尔计数从纹波估计值接续，保持里程连续。
  */
 void motor_drv_hall_enable(void)
 {
     HALL_EN_CLK_ENABLE();  // 打开 HALL_EN 所在 GPIO 口的时钟
 
+    if (!s_hall_enabled)
+    {
+        s_hall_on_tick = HAL_GetTick();
+        s_hall_adopt_pending = 1;
+    }
+
     HAL_GPIO_WritePin(HALL_EN_PORT, HALL_EN_PIN, HALL_EN_ACTIVE_LEVEL); //把 HALL_EN 引脚拉到“有效电平
 
     s_hall_enabled = 1; //更新状态：已打开
@@ -206,11 +318,21 @@ void motor_drv_hall_enable(void)
 
 /**
  * @brief 关闭霍尔模块公共使能（HALL_EN）输出。
+ * @note  以当前霍尔计数作为纹波估计起点，关闭期间由纹波计数接管位置。
  */
 void motor_drv_hall_disable(void)
 {
     HALL_EN_CLK_ENABLE();  // 打开 HALL_EN 所在 GPIO 口的时钟
 
+    // 稳定期内关闭：纹波估计仍是当前位置，不用重新设起点
+    if (s_hall_enabled && !s_hall_adopt_pending)
+    {
+        for (int i = 0; i < MOTOR_NUM; i++)
+        {
+            motor_ripple_seed((motor_id_t)i, s_hall_cnt[i]);
+        }
+    }
+
     HAL_GPIO_WritePin(HALL_EN_PORT, HALL_EN_PIN, (HALL_EN_ACTIVE_LEVEL == GPIO_PIN_SET) ? GPIO_PIN_RESET : GPIO_PIN_SET); //把 HALL_EN 引脚拉到“无效电平
 
     s_hall_enabled = 0; //更新状态：已关闭
@@ -225,6 +347,43 @@ uint8_t motor_drv_hall_is_enabled(void)
     return s_hall_enabled;  // 返回当前是否使能
 }
 
+/**
+ * @brief  获取指定电机的位置计数
+ * @param  id: 电机ID
+ * @note   霍尔打开时返回霍尔计数；霍尔关闭或上电稳定期内返回纹波估计计数（同口径）。
+ * @retval 位置计数，越界返回0
+ */
+uint32_t motor_drv_pos_get_count(motor_id_t id)
+{
+    if (id >= MOTOR_NUM) 
+    {
+        return 0;
+    }
+    if (!s_hall_enabled || hall_is_settling())
+    {
+        return motor_ripple_get_count(id);
+    }
+    return s_hall_cnt[id];
+}
+
+/**
+ * @brief  获取位置计数的置信度
+ * @param  id: 电机ID
+ * @retval 霍尔打开时为100；霍尔关闭时为纹波估计置信度(0~100)
+ */
+uint8_t motor_drv_pos_get_confidence(motor_id_t id)
+{
+    if (id >= MOTOR_NUM) 
+    {
+        return 0;
+    }
+    if (!s_hall_enabled || hall_is_settling())
+    {
+        return motor_ripple_get_confidence(id);
+    }
+    return 100U;
+}
+
 
 /******************************************************************************
  *                            中断回调函数
@@ -233,11 +392,17 @@ uint8_t motor_drv_hall_is_enabled(void)
 /**
  * @brief  GPIO外部中断回调函数
  * @param  GPIO_Pin: 触发中断的GPIO引脚编号
- * @note   霍尔传感器上升沿触发，对应电机计数器自增
+ * @note   霍尔传感器上升沿触发，对应电机计数器自增；
+ *         霍尔上电稳定期内的边沿是毛刺，丢弃
  * @retval None
  */
 void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 {
+    if (hall_is_settling())
+    {
+        return;
+    }
+
     if (GPIO_Pin == MOTOR1_HALL_IN_PIN)
     {
         s_hall_cnt[MOTOR1]++;
@@ -268,47 +433,43 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
  *                            电机采集电流函数
  ******************************************************************************/
 
-extern ADC_HandleTypeDef hadc1;  // 声明ADC句柄
-
-static uint16_t s_motor_adc_buf[MOTOR_NUM] = { 0 };//DMA缓冲，存放MOTOR_NUM路电机电流ADC原始值
-
 #define R_SHUNT_OHM 0.01f // 分流电阻阻值，单位欧姆
 #define AMP_GAIN    20.0f //电流采样放大倍数，示例：20倍
-#define ADC_VREF    3.3f  // ADC参考电压，单位伏特
-#define ADC_FULL_SCALE 4096.0f //ADC满量程值（12位ADC）
 
 /**
  * @brief  启动电机电流采样（ADC1 扫描 + DMA 循环模式）
  * @param  None
- * @note   使用 ADC1 多通道扫描，将 MOTOR_NUM 路电流采样结果通过 DMA
- *         连续写入 s_motor_adc_buf[]，DMA 为 Circular 模式保证缓冲区实时更新。
+ * @note   使用 adc_frame 模块的全通道扫描，电机电流是每帧的前 MOTOR_NUM 个通道，
+ *         DMA 为 Circular 模式保证缓冲区实时更新。
  *         为什么用Circular模式？因为 Circular 模式能让 DMA 自动循环把 ADC 采样结果持续更新到缓冲区里，软件不用反复启动采样就能一直拿到最新电流值。
+ *         同时挂上纹波计数估计器，霍尔关闭时由它提供位置。
  * @retval None
  * 
  */
 void motor_drv_current_init(void)
 {
-    HAL_ADC_Start_DMA(&hadc1,(uint32_t *)s_motor_adc_buf,MOTOR_NUM);
+    adc_frame_init();
+    motor_ripple_init();
 }
 
 /**
  * @brief  读取指定电机的原始 ADC 采样值
  * @param  id: 电机编号/ID（对应 ADC 扫描通道顺序）
- * @note   返回值为 ADC 原始码，范围通常为 0~4095（12bit）。
+ * @note   返回值为 ADC 码值（已按 Vrefint 补偿到标称 ADC_VREF_MV），范围 0~4095（12bit）。
  *         若 id 越界则返回 0。
  * @retval 指定电机的 ADC 原始值(uint16_t)
  */
 uint16_t motor_drv_get_current_raw(motor_id_t id)
 {
     if (id >= MOTOR_NUM) return 0;
-    return s_motor_adc_buf[id];
+    return adc_frame_get_raw((adc_frame_ch_t)(ADC_FRAME_MOTOR1_CURRENT + id));
 }
 
 /**
  * @brief  读取指定电机的实际电流值
  * @param  id: 电机编号/ID（对应 ADC 扫描通道顺序）
  * @note   换算公式：
- *           1) v_sense = (adc / ADC_FULL_SCALE) * ADC_VREF
+ *           1) v_sense = 码值对应的毫伏（adc_frame 已按 Vrefint 补偿供电跌落）
  *           2) I = v_sense / (R_SHUNT_OHM * AMP_GAIN)
  *         其中 R_SHUNT_OHM、AMP_GAIN 为当前默认示例值，需按实际硬件修正。
  *         若 id 越界则返回 0.0f。
@@ -318,8 +479,7 @@ float motor_drv_get_current_A(motor_id_t id)
 {
     if (id >= MOTOR_NUM) return 0.0f;
 
-    float adc = (float)s_motor_adc_buf[id];
-    float v_sense = (adc / ADC_FULL_SCALE) * ADC_VREF;   // ADC→电压
+    float v_sense = (float)adc_frame_code_to_mv(motor_drv_get_current_raw(id)) * 0.001f;  // ADC→电压
     float current = v_sense / (R_SHUNT_OHM * AMP_GAIN);  // 电压→电流
 
     return current;
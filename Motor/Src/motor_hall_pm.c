@@ -0,0 +1,91 @@
+#include "motor_hall_pm.h"
+#include "motor_drv.h"
+
+/******************************************************************************
+ *                              私有变量定义
+ ******************************************************************************/
+
+static volatile uint8_t  s_pm_active = 0;      // 自动管理是否启用
+static volatile uint32_t s_idle_off_ms = MOTOR_HALL_PM_IDLE_OFF_MS_DEFAULT;
+static volatile uint32_t s_idle_ms = 0;        // 所有电机连续停止的时间
+
+/******************************************************************************
+ *                              内部工具函数
+ ******************************************************************************/
+
+/**
+ * @brief 是否有任一电机处于运动指令状态
+ */
+static uint8_t pm_any_motor_running(void)
+{
+    for (int i = 0; i < MOTOR_NUM; i++)
+    {
+        if (motor_drv_get_dir((motor_id_t)i) != MOTOR_DIR_STOP)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 上电（已上电则只重置空闲计时）
+ */
+static void pm_wake(void)
+{
+    s_idle_ms = 0;
+    if (!motor_drv_hall_is_enabled())
+    {
+        motor_drv_hall_enable();
+    }
+}
+
+/******************************************************************************
+ *                              对外接口
+ ******************************************************************************/
+
+void motor_hall_pm_init(uint32_t idle_off_ms)
+{
+    s_idle_off_ms = idle_off_ms;
+    pm_wake();
+    s_pm_active = 1;
+}
+
+void motor_hall_pm_set_idle_off_ms(uint32_t idle_off_ms)
+{
+    s_idle_off_ms = idle_off_ms;
+    s_idle_ms = 0;
+}
+
+void motor_hall_pm_prewake(void)
+{
+    if (!s_pm_active) return;
+    pm_wake();
+}
+
+void motor_hall_pm_notify_motion(void)
+{
+    if (!s_pm_active) return;
+    pm_wake();
+}
+
+void motor_hall_pm_tick_1ms(void)
+{
+    if (!s_pm_active) return;
+
+    if (pm_any_motor_running())
+    {
+        s_idle_ms = 0;
+        return;
+    }
+
+    if (s_idle_off_ms == 0U || !motor_drv_hall_is_enabled())
+    {
+        return;
+    }
+
+    if (++s_idle_ms >= s_idle_off_ms)
+    {
+        motor_drv_hall_disable();
+    }
+}
@@ -0,0 +1,185 @@
+#include "motor_ripple.h"
+#include "motor_drv.h"
+#include "adc_frame.h"
+
+/******************************************************************************
+ *                              私有类型定义
+ ******************************************************************************/
+
+/**
+ * @brief 单个电机的纹波检测状态
+ * @note  信号链（全部整数运算，Q8 定点）：
+ *          x ──> 减去直流均值(高通) ──> 一阶低通 ──> 带通信号 bp
+ *          |bp| ──> 包络 env
+ *          bp 过 ±env/2 施密特触发，低->高翻转计一个纹波
+ */
+typedef struct
+{
+    int32_t  dc_q8;         ///< 电流直流分量（Q8）
+    int32_t  bp_q8;         ///< 带通输出（Q8）
+    int32_t  env_q8;        ///< 带通幅值包络（Q8）
+    uint8_t  high;          ///< 施密特触发器当前状态
+    uint8_t  confidence;    ///< 置信度 0~100
+    uint16_t since;         ///< 距上一个纹波的帧数
+    uint32_t period_q4;     ///< 纹波平均周期（帧，Q4）
+    uint32_t jitter_q4;     ///< 周期平均偏差（帧，Q4）
+    uint32_t ripple_cnt;    ///< 自起点以来检测到的纹波数
+    uint32_t base_count;    ///< 起点霍尔计数
+} ripple_state_t;
+
+/******************************************************************************
+ *                              私有变量定义
+ ******************************************************************************/
+
+static ripple_state_t s_ripple[MOTOR_NUM];
+
+/******************************************************************************
+ *                              内部工具函数
+ ******************************************************************************/
+
+/**
+ * @brief 根据包络和周期抖动计算置信度
+ */
+static uint8_t ripple_calc_confidence(const ripple_state_t *st)
+{
+    uint32_t amp_score;
+    uint32_t reg_score;
+
+    // 幅值：包络达到门限4倍视为满分
+    amp_score = (uint32_t)st->env_q8 * 100U / ((MOTOR_RIPPLE_MIN_AMPLITUDE_RAW * 4U) << 8);
+    if (amp_score > 100U) amp_score = 100U;
+
+    // 周期一致性：平均偏差达到周期一半视为0分
+    if (st->period_q4 == 0U)
+    {
+        reg_score = 0U;
+    }
+    else
+    {
+        uint32_t rel = st->jitter_q4 * 200U / st->period_q4;
+        reg_score = (rel >= 100U) ? 0U : (100U - rel);
+    }
+
+    return (uint8_t)((amp_score < reg_score) ? amp_score : reg_score);
+}
+
+/**
+ * @brief 处理单个电机的一个电流采样
+ */
+static void ripple_process_sample(ripple_state_t *st, motor_id_t id, uint16_t raw)
+{
+    int32_t x_q8 = (int32_t)raw << 8;
+    int32_t bp_abs;
+    int32_t th;
+
+    // 1) 带通：跟踪直流分量并减去，再做一次低通
+    st->dc_q8 += (x_q8 - st->dc_q8) >> MOTOR_RIPPLE_DC_SHIFT;
+    st->bp_q8 += ((x_q8 - st->dc_q8) - st->bp_q8) >> MOTOR_RIPPLE_LP_SHIFT;
+
+    // 2) 幅值包络
+    bp_abs = (st->bp_q8 < 0) ? -st->bp_q8 : st->bp_q8;
+    st->env_q8 += (bp_abs - st->env_q8) >> MOTOR_RIPPLE_ENV_SHIFT;
+
+    if (st->since < 0xFFFFU) st->since++;
+
+    // 3) 未运行/电流太小/纹波太弱：不计数
+    if (motor_drv_get_dir(id) == MOTOR_DIR_STOP
+        || st->dc_q8 < (int32_t)(MOTOR_RIPPLE_MIN_CURRENT_RAW << 8)
+        || st->env_q8 < (int32_t)(MOTOR_RIPPLE_MIN_AMPLITUDE_RAW << 8))
+    {
+        st->high = 0;
+        return;
+    }
+
+    // 4) 施密特触发，迟滞 = ±env/2
+    th = st->env_q8 >> 1;
+    if (st->high)
+    {
+        if (st->bp_q8 < -th) st->high = 0;
+    }
+    else if (st->bp_q8 > th && st->since >= MOTOR_RIPPLE_MIN_PERIOD)
+    {
+        uint32_t p_q4 = (uint32_t)st->since << 4;
+        uint32_t dev = (p_q4 > st->period_q4) ? (p_q4 - st->period_q4) : (st->period_q4 - p_q4);
+
+        st->high = 1;
+        st->ripple_cnt++;
+
+        if (st->period_q4 == 0U)
+        {
+            st->period_q4 = p_q4;   // 第一个纹波直接作为初值
+        }
+        else
+        {
+            st->period_q4 = st->period_q4 + (p_q4 >> 3) - (st->period_q4 >> 3);
+            st->jitter_q4 = st->jitter_q4 + (dev >> 3) - (st->jitter_q4 >> 3);
+        }
+        st->since = 0;
+        st->confidence = ripple_calc_confidence(st);
+        return;
+    }
+
+    // 5) 运行中长时间无纹波：堵转或漏检，估计不可信
+    if (st->since > MOTOR_RIPPLE_MAX_PERIOD)
+    {
+        st->confidence = 0;
+        st->period_q4 = 0;
+        st->jitter_q4 = 0;
+    }
+}
+
+/**
+ * @brief ADC 帧回调：6路电机电流逐个处理
+ */
+static void ripple_on_adc_frame(const uint16_t *frame)
+{
+    for (int i = 0; i < MOTOR_NUM; i++)
+    {
+        ripple_process_sample(&s_ripple[i], (motor_id_t)i, frame[ADC_FRAME_MOTOR1_CURRENT + i]);
+    }
+}
+
+/******************************************************************************
+ *                              对外接口
+ ******************************************************************************/
+
+void motor_ripple_init(void)
+{
+    for (int i = 0; i < MOTOR_NUM; i++)
+    {
+        s_ripple[i] = (ripple_state_t){0};
+        s_ripple[i].confidence = 100;   // 静止起点是准确的
+    }
+    adc_frame_register_hook(ripple_on_adc_frame);
+}
+
+void motor_ripple_seed(motor_id_t id, uint32_t hall_count)
+{
+    if (id >= MOTOR_NUM) return;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    s_ripple[id].base_count = hall_count;
+    s_ripple[id].ripple_cnt = 0;
+    __set_PRIMASK(primask);
+}
+
+uint32_t motor_ripple_get_count(motor_id_t id)
+{
+    if (id >= MOTOR_NUM) return 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    uint32_t base = s_ripple[id].base_count;
+    uint32_t ripples = s_ripple[id].ripple_cnt;
+    __set_PRIMASK(primask);
+
+    // 纹波数 -> 霍尔计数口径（四舍五入）
+    return base + (ripples * MOTOR_RIPPLE_HALL_EDGES_PER_REV + MOTOR_RIPPLE_PER_REV / 2U) / MOTOR_RIPPLE_PER_REV;
+}
+
+uint8_t motor_ripple_get_confidence(motor_id_t id)
+{
+    if (id >= MOTOR_NUM) return 0;
+    return s_ripple[id].confidence;
+}
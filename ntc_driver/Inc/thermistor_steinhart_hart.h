@@ -0,0 +1,51 @@
+#ifndef THERMISTOR_STEINHART_HART_H
+#define THERMISTOR_STEINHART_HART_H
+
+#include <stdint.h>
+#include "thermistor_temperature_driver.h"
+/**
+ * @brief Steinhart–Hart 逐只标定的NTC转换
+ *
+ * beta 模型只有一个参数，在 20~150℃ 两端会偏几度；Steinhart–Hart
+ *   1/T = A + B·ln(R) + C·ln(R)^3
+ * 用三个标定点解出 A/B/C，整个量程误差基本只剩标定点本身的误差。
+ *
+ * 标定流程（现场/产线）：
+ *   1) 把NTC依次放到三个已知温度（建议覆盖使用范围两端和中间，如 25/85/150℃）
+ *   2) 每个温度稳定后取ADC平均值（建议不少于256帧）
+ *   3) 调用 thermistor_sh_calibrate 解算、校验并写入非易失配置
+ * 三点解在标定点上必然精确吻合，所以校验看标定点之间：中间点上与默认 beta 模型偏差过大
+ * （参考温度记错、采样没稳定）就拒绝；失败时原有标定保持不变。
+ *
+ * 运行时：上电 thermistor_sh_init 从配置读回系数，为每路已标定的NTC生成一张
+ * 与默认型号表同格式的RAM表（THERMISTOR_TABLE_SIZE 项，高位索引+线性插值），
+ * 之后每次转换只是一次查表插值，可以在每个ADC帧里调用。未标定的路使用默认型号表。
+ * 重新标定时新表生成在备用表里，成功后一次指针交换生效，转换过程中不会退回默认表。
+ */
+#define THERMISTOR_SH_SENSOR_NUM        2U      // NTC1/NTC2
+#define THERMISTOR_SH_CAL_POINTS        3U
+#define THERMISTOR_SH_CAL_MIN_GAP_CENTI 1000    // 标定点之间至少相差 10℃
+#define THERMISTOR_SH_CAL_MAX_DEV_CENTI 500     // 标定点之间的中间点上与默认 beta 模型的最大偏差
+
+typedef struct{
+    uint16_t raw;           // 该温度下的ADC平均值
+    int32_t  ref_centi;     // 参考温度（0.01℃）
+}thermistor_cal_point_t;
+
+typedef enum{
+    THERMISTOR_SH_OK = 0,
+    THERMISTOR_SH_ERR_PARAM,        // 传感器编号/采样值非法
+    THERMISTOR_SH_ERR_POINTS,       // 标定点温度太近或顺序与NTC特性矛盾
+    THERMISTOR_SH_ERR_MODEL,        // 解出的模型不单调或与默认模型偏差过大
+    THERMISTOR_SH_ERR_STORE         // 写入非易失配置失败（本次上电仍生效）
+}thermistor_sh_result_t;
+/******************************************************************************
+ *                              函数声明
+ ******************************************************************************/
+void thermistor_sh_init(void);
+thermistor_sh_result_t thermistor_sh_calibrate(uint8_t sensor, const thermistor_cal_point_t points[THERMISTOR_SH_CAL_POINTS]);
+uint8_t thermistor_sh_clear(uint8_t sensor);
+uint8_t thermistor_sh_is_calibrated(uint8_t sensor);
+int32_t thermistor_sh_centi_celsius(uint8_t sensor, uint16_t raw);
+
+#endif // THERMISTOR_STEINHART_HART_H
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <math.h>
+#include "thermistor_parts.h"   // 构建时由 ntc_driver/params 生成
 /**
  * @brief 把模数转换器(ADC)采样值转换成摄氏温度
  * @param analog_to_digital_converter_value  12位ADC采样原始值（0~4095）
@@ -11,4 +12,24 @@
  */
 float convert_analog_to_digital_converter_value_to_temperature_celsius(uint16_t analog_to_digital_converter_value);
 
+/**
+ * @brief 查表版：ADC采样值 -> 温度（0.01℃，整数）
+ * @note  按ADC值高位查表再线性插值，没有浮点/对数运算，可以在每个ADC帧里调用。
+ *        相对 beta 模型，THERMISTOR_TABLE_ERR_RANGE_LO_C~HI_C 内误差不超过
+ *        THERMISTOR_<型号>_MAX_ERR_CENTI（构建时生成并打印）。
+ *        不带 _for_part 的版本使用默认型号 THERMISTOR_PART_DEFAULT。
+ * @return 温度（0.01℃）；采样异常时返回与浮点版对应的极端值：
+ *         THERMISTOR_CENTI_SHORT（-273.15℃，短路）/ THERMISTOR_CENTI_OPEN（999.0℃，断路）
+ */
+#define THERMISTOR_CENTI_SHORT      (-27315)
+#define THERMISTOR_CENTI_OPEN       99900
+int32_t convert_analog_to_digital_converter_value_to_temperature_centi_celsius(uint16_t analog_to_digital_converter_value);
+int32_t convert_analog_to_digital_converter_value_to_temperature_centi_celsius_for_part(thermistor_part_t part, uint16_t analog_to_digital_converter_value);
+
+/**
+ * @brief 在任意同格式的表（THERMISTOR_TABLE_SIZE 项，间隔 1<<THERMISTOR_TABLE_SHIFT）上查表插值
+ */
+int32_t thermistor_table_lookup_centi(const int32_t *table, uint16_t analog_to_digital_converter_value);
+float thermistor_adc_to_resistance_ohms(float analog_to_digital_converter_value);
+
 #endif // THERMISTOR_TEMPERATURE_DRIVER_H
\ No newline at end of file
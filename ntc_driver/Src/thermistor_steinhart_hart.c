@@ -0,0 +1,230 @@
+#include "thermistor_steinhart_hart.h"
+#include "nv_config.h"
+
+/******************************************************************
+ * 内部状态
+ ******************************************************************/
+
+/* 转换表（RAM，上电/标定时由系数生成）：每路一张，外加一张备用，标定时生成在备用表里再交换 */
+static int32_t s_sh_tables[THERMISTOR_SH_SENSOR_NUM + 1U][THERMISTOR_TABLE_SIZE];
+static const int32_t *volatile s_sh_table[THERMISTOR_SH_SENSOR_NUM];   // 各路当前使用的表
+static int32_t *s_sh_spare = s_sh_tables[THERMISTOR_SH_SENSOR_NUM];
+static volatile uint8_t s_sh_valid[THERMISTOR_SH_SENSOR_NUM];
+
+/******************************************************************
+ * 内部工具函数
+ ******************************************************************/
+
+/**
+ * @brief 用 Steinhart–Hart 系数把ADC值换算成温度（0.01℃），只用于生成表
+ */
+static int32_t thermistor_sh_eval_centi(const nv_ntc_cal_t *cal, float raw)
+{
+    float ln_r = logf(thermistor_adc_to_resistance_ohms(raw));
+    float inv_t = cal->a + cal->b * ln_r + cal->c * ln_r * ln_r * ln_r;
+
+    if(!(inv_t > 0.0f)) return THERMISTOR_CENTI_OPEN;   // 超出模型有效范围
+    return (int32_t)lroundf((1.0f / inv_t - 273.15f) * 100.0f);
+}
+
+/**
+ * @brief 由系数生成转换表
+ * @return 1=表在整个量程上单调（NTC：阻值越大温度越低），0=模型不可用
+ */
+static uint8_t thermistor_sh_build_table(const nv_ntc_cal_t *cal, int32_t *table)
+{
+    for(uint32_t i = 0; i < THERMISTOR_TABLE_SIZE; i++)
+    {
+        uint32_t raw = i << THERMISTOR_TABLE_SHIFT;
+        if(raw < 2U)    raw = 2U;       // 两端钳到有效采样范围，与生成脚本一致
+        if(raw > 4093U) raw = 4093U;
+        table[i] = thermistor_sh_eval_centi(cal, (float)raw);
+    }
+
+    for(uint32_t i = 1; i < THERMISTOR_TABLE_SIZE; i++)
+    {
+#if THERMISTOR_AT_BOTTOM
+        if(table[i] > table[i - 1U]) return 0;  // 采样值升高 = 阻值变大 = 温度降低
+#else
+        if(table[i] < table[i - 1U]) return 0;
+#endif
+    }
+    return 1;
+}
+
+/**
+ * @brief 三点解 Steinhart–Hart 系数
+ * 记 L = ln(R)，Y = 1/T：
+ *   g2 = (Y2-Y1)/(L2-L1)，g3 = (Y3-Y1)/(L3-L1)
+ *   C  = (g3-g2) / ((L3-L2)(L1+L2+L3))
+ *   B  = g2 - C(L1² + L1·L2 + L2²)
+ *   A  = Y1 - (B + C·L1²)·L1
+ * 只在标定时算一次，用双精度避免相减抵消。
+ */
+static void thermistor_sh_solve(const thermistor_cal_point_t *p, nv_ntc_cal_t *cal)
+{
+    double l[THERMISTOR_SH_CAL_POINTS];
+    double y[THERMISTOR_SH_CAL_POINTS];
+
+    for(uint32_t i = 0; i < THERMISTOR_SH_CAL_POINTS; i++)
+    {
+        l[i] = log((double)thermistor_adc_to_resistance_ohms((float)p[i].raw));
+        y[i] = 1.0 / ((double)p[i].ref_centi / 100.0 + 273.15);
+    }
+
+    double g2 = (y[1] - y[0]) / (l[1] - l[0]);
+    double g3 = (y[2] - y[0]) / (l[2] - l[0]);
+    double c  = (g3 - g2) / ((l[2] - l[1]) * (l[0] + l[1] + l[2]));
+    double b  = g2 - c * (l[0] * l[0] + l[0] * l[1] + l[1] * l[1]);
+    double a  = y[0] - (b + c * l[0] * l[0]) * l[0];
+
+    cal->a = (float)a;
+    cal->b = (float)b;
+    cal->c = (float)c;
+}
+
+/**
+ * @brief 标定点检查：温度两两拉开，且温度越高阻值越小（采样值方向符合分压结构）
+ */
+static uint8_t thermistor_sh_points_ok(const thermistor_cal_point_t *p)
+{
+    for(uint32_t i = 0; i < THERMISTOR_SH_CAL_POINTS; i++)
+    {
+        if(p[i].raw <= 1U || p[i].raw >= 4094U) return 0;
+        for(uint32_t j = i + 1U; j < THERMISTOR_SH_CAL_POINTS; j++)
+        {
+            int32_t dt = p[i].ref_centi - p[j].ref_centi;
+            int32_t dr = (int32_t)p[i].raw - (int32_t)p[j].raw;
+
+            if(dt < THERMISTOR_SH_CAL_MIN_GAP_CENTI && dt > -THERMISTOR_SH_CAL_MIN_GAP_CENTI) return 0;
+#if THERMISTOR_AT_BOTTOM
+            if((dt > 0) == (dr > 0) || dr == 0) return 0;
+#else
+            if((dt > 0) != (dr > 0) || dr == 0) return 0;
+#endif
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief 模型检查：相邻标定点之间的 1/4、1/2、3/4 处与默认 beta 模型比较
+ * @note  三点解在标定点上的残差恒为 0，检查不出问题，只能看标定点之间
+ */
+static uint8_t thermistor_sh_model_ok(const nv_ntc_cal_t *cal, const thermistor_cal_point_t *p)
+{
+    uint16_t r[THERMISTOR_SH_CAL_POINTS];
+
+    for(uint32_t i = 0; i < THERMISTOR_SH_CAL_POINTS; i++) r[i] = p[i].raw;
+    for(uint32_t i = 1; i < THERMISTOR_SH_CAL_POINTS; i++)     // 插入排序，按采样值升序
+    {
+        for(uint32_t j = i; j > 0U && r[j - 1U] > r[j]; j--)
+        {
+            uint16_t t = r[j]; r[j] = r[j - 1U]; r[j - 1U] = t;
+        }
+    }
+
+    for(uint32_t i = 1; i < THERMISTOR_SH_CAL_POINTS; i++)
+    {
+        for(uint32_t q = 1; q < 4U; q++)
+        {
+            uint16_t raw = (uint16_t)(r[i - 1U] + (uint32_t)(r[i] - r[i - 1U]) * q / 4U);
+            int32_t dev = thermistor_sh_eval_centi(cal, (float)raw)
+                        - convert_analog_to_digital_converter_value_to_temperature_centi_celsius(raw);
+
+            if(dev > THERMISTOR_SH_CAL_MAX_DEV_CENTI || dev < -THERMISTOR_SH_CAL_MAX_DEV_CENTI) return 0;
+        }
+    }
+    return 1;
+}
+
+/******************************************************************
+ * 对外接口
+ ******************************************************************/
+
+/**
+ * @brief 从非易失配置读回各路系数并生成转换表
+ * @note  需在 nv_config_init 之后调用；每路约 THERMISTOR_TABLE_SIZE 次 logf
+ */
+void thermistor_sh_init(void)
+{
+    const nv_config_t *cfg = nv_config_get();
+
+    s_sh_spare = s_sh_tables[THERMISTOR_SH_SENSOR_NUM];
+    for(uint8_t i = 0; i < THERMISTOR_SH_SENSOR_NUM; i++)
+    {
+        s_sh_valid[i] = 0;
+        s_sh_table[i] = s_sh_tables[i];
+        if(i < NV_CONFIG_NTC_NUM && cfg->ntc_cal[i].valid == 1U)
+        {
+            s_sh_valid[i] = thermistor_sh_build_table(&cfg->ntc_cal[i], s_sh_tables[i]);
+        }
+    }
+}
+
+/**
+ * @brief 三点标定：解算系数、校验、生成转换表并写入非易失配置
+ * @param sensor 0=NTC1，1=NTC2
+ * @param points 三个标定点，顺序不限
+ * @note  写 flash 会挂起 CPU 数十毫秒，调用前关闭加热；校验失败时原有标定和转换表不变
+ */
+thermistor_sh_result_t thermistor_sh_calibrate(uint8_t sensor, const thermistor_cal_point_t points[THERMISTOR_SH_CAL_POINTS])
+{
+    nv_ntc_cal_t cal = {0};
+
+    if(sensor >= THERMISTOR_SH_SENSOR_NUM || sensor >= NV_CONFIG_NTC_NUM || points == 0) return THERMISTOR_SH_ERR_PARAM;
+    if(!thermistor_sh_points_ok(points)) return THERMISTOR_SH_ERR_POINTS;
+
+    thermistor_sh_solve(points, &cal);
+    if(!thermistor_sh_model_ok(&cal, points)) return THERMISTOR_SH_ERR_MODEL;
+    for(uint32_t i = 0; i < THERMISTOR_SH_CAL_POINTS; i++)
+    {
+        cal.raw[i] = points[i].raw;
+        cal.ref_centi[i] = points[i].ref_centi;
+    }
+    cal.valid = 1U;
+
+    // 新表生成在备用表里，ADC帧照旧用原来的表；成功后交换指针，旧表成为备用
+    if(!thermistor_sh_build_table(&cal, s_sh_spare)) return THERMISTOR_SH_ERR_MODEL;
+    int32_t *old = (int32_t *)s_sh_table[sensor];
+    s_sh_table[sensor] = s_sh_spare;
+    s_sh_valid[sensor] = 1;
+    s_sh_spare = old;
+
+    nv_config_t cfg = *nv_config_get();
+    cfg.ntc_cal[sensor] = cal;
+    return nv_config_save(&cfg) ? THERMISTOR_SH_OK : THERMISTOR_SH_ERR_STORE;
+}
+
+/**
+ * @brief 删除某路标定，恢复默认型号表
+ * @return 1=成功，0=参数错误或写入失败
+ */
+uint8_t thermistor_sh_clear(uint8_t sensor)
+{
+    if(sensor >= THERMISTOR_SH_SENSOR_NUM || sensor >= NV_CONFIG_NTC_NUM) return 0;
+
+    s_sh_valid[sensor] = 0;
+    nv_config_t cfg = *nv_config_get();
+    cfg.ntc_cal[sensor] = (nv_ntc_cal_t){0};
+    return nv_config_save(&cfg);
+}
+
+uint8_t thermistor_sh_is_calibrated(uint8_t sensor)
+{
+    if(sensor >= THERMISTOR_SH_SENSOR_NUM) return 0;
+    return s_sh_valid[sensor];
+}
+
+/**
+ * @brief ADC值 -> 温度（0.01℃）：已标定用该路的 Steinhart–Hart 表，否则用默认型号表
+ * @return 温度；采样异常返回 THERMISTOR_CENTI_SHORT / THERMISTOR_CENTI_OPEN
+ */
+int32_t thermistor_sh_centi_celsius(uint8_t sensor, uint16_t raw)
+{
+    if(sensor < THERMISTOR_SH_SENSOR_NUM && s_sh_valid[sensor])
+    {
+        return thermistor_table_lookup_centi(s_sh_table[sensor], raw);     // 指针单次读取，交换是原子的
+    }
+    return convert_analog_to_digital_converter_value_to_temperature_centi_celsius(raw);
+}
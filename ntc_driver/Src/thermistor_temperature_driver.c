@@ -11,17 +11,19 @@
 
 /******************************************************************
  * 热敏电阻（负温度系数热敏电阻）参数
- * 这些值与硬件真实参数对应
+ * 来自构建时生成的 thermistor_parts.h：型号参数在 ntc_driver/params/<型号>.ntc，
+ * 分压参数和型号列表在 CMake 里配置（NTC_PARTS / NTC_PULLUP_OHMS / NTC_AT_BOTTOM），
+ * 浮点路径使用默认型号（NTC_PARTS 的第一个）。
  ******************************************************************/
 
-/* 25℃时热敏电阻阻值（常见10k） */
-#define THERMISTOR_RESISTANCE_AT_25_CELSIUS_OHMS               10000.0f
-/* 热敏电阻Beta系数（常见3950） */
-#define THERMISTOR_BETA_COEFFICIENT                            3950.0f
-/* 参考温度25℃对应的开尔文温度 */
-#define THERMISTOR_REFERENCE_TEMPERATURE_KELVIN                298.15f
-/* 分压用的固定上拉电阻阻值（常见10k） */
-#define PULLUP_RESISTOR_OHMS                                  10000.0f
+/* 25℃时热敏电阻阻值 */
+#define THERMISTOR_RESISTANCE_AT_25_CELSIUS_OHMS               THERMISTOR_DEFAULT_R25_OHMS
+/* 热敏电阻Beta系数 */
+#define THERMISTOR_BETA_COEFFICIENT                            THERMISTOR_DEFAULT_BETA
+/* 参考温度对应的开尔文温度 */
+#define THERMISTOR_REFERENCE_TEMPERATURE_KELVIN                THERMISTOR_DEFAULT_T0_KELVIN
+/* 分压用的固定电阻阻值 */
+#define PULLUP_RESISTOR_OHMS                                  THERMISTOR_PULLUP_OHMS
 
 /******************************************************************
  * 分压结构选择
@@ -30,7 +32,7 @@
  * 0：3.3V -> 热敏电阻 ->（采样节点）-> 固定上拉电阻 -> 地
  *
  ******************************************************************/
-#define THERMISTOR_CONNECTED_TO_GROUND_AT_BOTTOM                  1
+#define THERMISTOR_CONNECTED_TO_GROUND_AT_BOTTOM                  THERMISTOR_AT_BOTTOM
 
 float convert_analog_to_digital_converter_value_to_temperature_celsius(uint16_t analog_to_digital_converter_value)
 {
@@ -94,4 +96,51 @@ float convert_analog_to_digital_converter_value_to_temperature_celsius(uint16_t
     float temperature_kelvin = 1.0f / inverse_temperature_kelvin;
     /*5) 开尔文温度 -> 摄氏温度*/
     return temperature_kelvin - 273.15f;
-}
\ No newline at end of file
+}
+
+/******************************************************************
+ * 查表转换
+ *
+ * 表由 tools/ntc_table_gen.py 在构建时按与上面相同的 beta 模型生成，每个型号一张：
+ * 第 i 项 = ADC值 (i << THERMISTOR_TABLE_SHIFT) 处的温度（0.01℃），
+ * 采样值取高位做索引、低位在相邻两项之间线性插值。表在 flash 里，开机不需要计算。
+ ******************************************************************/
+int32_t thermistor_table_lookup_centi(const int32_t *table, uint16_t analog_to_digital_converter_value)
+{
+    /*1）边界保护：与浮点版一致*/
+    if(analog_to_digital_converter_value <= 1)    return THERMISTOR_CENTI_SHORT;
+    if(analog_to_digital_converter_value >= 4094) return THERMISTOR_CENTI_OPEN;
+
+    /*2）高位索引 + 低位插值*/
+    uint32_t index = (uint32_t)analog_to_digital_converter_value >> THERMISTOR_TABLE_SHIFT;
+    int32_t  frac  = (int32_t)(analog_to_digital_converter_value & ((1U << THERMISTOR_TABLE_SHIFT) - 1U));
+    int32_t  t0    = table[index];
+    int32_t  t1    = table[index + 1U];
+
+    return t0 + (t1 - t0) * frac / (int32_t)(1U << THERMISTOR_TABLE_SHIFT);
+}
+
+int32_t convert_analog_to_digital_converter_value_to_temperature_centi_celsius_for_part(thermistor_part_t part, uint16_t analog_to_digital_converter_value)
+{
+    if(part >= THERMISTOR_PART_NUM) part = THERMISTOR_PART_DEFAULT;
+    return thermistor_table_lookup_centi(thermistor_tables[part], analog_to_digital_converter_value);
+}
+
+int32_t convert_analog_to_digital_converter_value_to_temperature_centi_celsius(uint16_t analog_to_digital_converter_value)
+{
+    return thermistor_table_lookup_centi(thermistor_tables[THERMISTOR_PART_DEFAULT], analog_to_digital_converter_value);
+}
+
+/**
+ * @brief ADC采样值 -> 热敏电阻阻值（欧），与浮点转换同一分压公式
+ * @note  给标定等非实时场合用；采样值需在 2~4093 之间
+ */
+float thermistor_adc_to_resistance_ohms(float analog_to_digital_converter_value)
+{
+    float ratio = analog_to_digital_converter_value / ANALOG_TO_DIGITAL_CONVERTER_MAX_VALUE;
+#if THERMISTOR_CONNECTED_TO_GROUND_AT_BOTTOM
+    return PULLUP_RESISTOR_OHMS * ratio / (1.0f - ratio);
+#else
+    return PULLUP_RESISTOR_OHMS * (1.0f - ratio) / ratio;
+#endif
+}
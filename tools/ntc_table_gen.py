@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""由 NTC 参数文件生成查表转换用的温度表（ADC原始值 -> 0.01℃）。
+
+每个参数文件（ntc_driver/params/<型号>.ntc）生成一张表：
+第 i 项是 raw = i << shift 处的温度，两项之间做线性插值。
+脚本同时按 beta 模型逐点比较，给出每张表的插值误差上界。
+
+输出两个文件：
+    thermistor_parts.h   型号枚举、默认型号参数、误差上界（可被任何模块包含）
+    thermistor_tables.c  各型号的温度表（只链接一份）
+
+由 CMake 在构建时调用，见顶层 CMakeLists.txt；单独使用：
+    python3 tools/ntc_table_gen.py --out-dir build/generated ntc_driver/params/ntc_10k_3950.ntc
+"""
+import argparse
+import math
+import os
+import re
+
+ADC_MAX = 4095
+
+
+def load_part(path):
+    """读取 key = value 格式的参数文件，# 之后为注释"""
+    part = {"name": os.path.splitext(os.path.basename(path))[0], "t0_celsius": 25.0}
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.split("#", 1)[0].strip()
+            if not line:
+                continue
+            key, value = (s.strip() for s in line.split("=", 1))
+            part[key] = float(value)
+    for key in ("r25_ohms", "beta"):
+        if key not in part:
+            raise SystemExit("%s: missing '%s'" % (path, key))
+    if not re.match(r"^[A-Za-z_][A-Za-z0-9_]*$", part["name"]):
+        raise SystemExit("%s: file name must be a C identifier" % path)
+    return part
+
+
+def beta_temp_c(raw, part, args):
+    """与 thermistor_temperature_driver.c 中的浮点路径相同的 beta 模型"""
+    ratio = raw / ADC_MAX
+    if args.ntc_at_bottom:
+        r = args.pullup * ratio / (1.0 - ratio)
+    else:
+        r = args.pullup * (1.0 - ratio) / ratio
+    inv_t = 1.0 / (part["t0_celsius"] + 273.15) + math.log(r / part["r25_ohms"]) / part["beta"]
+    return 1.0 / inv_t - 273.15
+
+
+def build_table(part, args):
+    step = 1 << args.shift
+    n = (ADC_MAX + 1) // step + 1
+    # 两端 raw=0/4096 没有物理意义，钳到有效采样范围内
+    return [round(beta_temp_c(min(max(i * step, 2), ADC_MAX - 2), part, args) * 100) for i in range(n)]
+
+
+def interp(tab, raw, shift):
+    i = raw >> shift
+    f = raw & ((1 << shift) - 1)
+    d = tab[i + 1] - tab[i]
+    return tab[i] + int(d * f / (1 << shift))    # C 整数除法向0取整
+
+
+def max_error(tab, part, args):
+    err = 0.0
+    for raw in range(2, ADC_MAX - 1):
+        t = beta_temp_c(raw, part, args)
+        if args.err_lo <= t <= args.err_hi:
+            err = max(err, abs(interp(tab, raw, args.shift) - t * 100))
+    return int(math.ceil(err))
+
+
+def write_file(path, text):
+    with open(path, "w", encoding="utf-8") as f:
+        f.write(text)
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("parts", nargs="+", help="参数文件，第一个为默认型号")
+    ap.add_argument("--out-dir", required=True)
+    ap.add_argument("--pullup", type=float, default=10000.0, help="分压固定电阻（欧）")
+    ap.add_argument("--ntc-at-bottom", type=int, default=1, help="1=NTC接地，0=NTC接电源")
+    ap.add_argument("--shift", type=int, default=4, help="插值低位数：表项间隔 = 1<<shift 个ADC码")
+    ap.add_argument("--err-lo", type=float, default=-40.0)
+    ap.add_argument("--err-hi", type=float, default=150.0)
+    args = ap.parse_args()
+
+    parts = [load_part(p) for p in args.parts]
+    for part in parts:
+        part["table"] = build_table(part, args)
+        part["err"] = max_error(part["table"], part, args)
+    size = len(parts[0]["table"])
+    default = parts[0]
+
+    h = []
+    h.append("/* 由 tools/ntc_table_gen.py 生成，请勿手工修改 */")
+    h.append("#ifndef THERMISTOR_PARTS_H")
+    h.append("#define THERMISTOR_PARTS_H")
+    h.append("")
+    h.append("#include <stdint.h>")
+    h.append("")
+    h.append("/* 分压：固定电阻 %g 欧，NTC%s */" % (args.pullup, "接地" if args.ntc_at_bottom else "接电源"))
+    h.append("#define THERMISTOR_PULLUP_OHMS           %.1ff" % args.pullup)
+    h.append("#define THERMISTOR_AT_BOTTOM             %d" % (1 if args.ntc_at_bottom else 0))
+    h.append("#define THERMISTOR_TABLE_SHIFT           %dU" % args.shift)
+    h.append("#define THERMISTOR_TABLE_SIZE            %dU" % size)
+    h.append("#define THERMISTOR_TABLE_ERR_RANGE_LO_C  %d" % int(args.err_lo))
+    h.append("#define THERMISTOR_TABLE_ERR_RANGE_HI_C  %d" % int(args.err_hi))
+    h.append("")
+    h.append("typedef enum{")
+    for part in parts:
+        h.append("    THERMISTOR_PART_%s,%s" % (part["name"].upper(),
+                 "    // 默认" if part is default else ""))
+    h.append("    THERMISTOR_PART_NUM")
+    h.append("}thermistor_part_t;")
+    h.append("")
+    h.append("#define THERMISTOR_PART_DEFAULT          THERMISTOR_PART_%s" % default["name"].upper())
+    h.append("")
+    h.append("/* 默认型号的 beta 模型参数（浮点转换路径使用） */")
+    h.append("#define THERMISTOR_DEFAULT_R25_OHMS      %.1ff" % default["r25_ohms"])
+    h.append("#define THERMISTOR_DEFAULT_BETA          %.1ff" % default["beta"])
+    h.append("#define THERMISTOR_DEFAULT_T0_KELVIN     %.2ff" % (default["t0_celsius"] + 273.15))
+    h.append("")
+    h.append("/* 各型号查表相对 beta 模型的最大插值误差（0.01℃），统计范围见 ERR_RANGE */")
+    for part in parts:
+        h.append("#define THERMISTOR_%s_MAX_ERR_CENTI %s%d" % (part["name"].upper(),
+                 " " * max(0, 16 - len(part["name"])), part["err"]))
+    h.append("#define THERMISTOR_TABLE_MAX_ERR_CENTI   THERMISTOR_%s_MAX_ERR_CENTI" % default["name"].upper())
+    h.append("")
+    h.append("extern const int32_t *const thermistor_tables[THERMISTOR_PART_NUM];")
+    h.append("")
+    h.append("#endif // THERMISTOR_PARTS_H")
+
+    c = []
+    c.append("/* 由 tools/ntc_table_gen.py 生成，请勿手工修改 */")
+    c.append('#include "thermistor_parts.h"')
+    for part in parts:
+        c.append("")
+        c.append("/* %s：R25=%g Beta=%g，最大误差 %d（0.01℃） */" % (part["name"], part["r25_ohms"],
+                                                                part["beta"], part["err"]))
+        c.append("static const int32_t s_table_%s[THERMISTOR_TABLE_SIZE] = {" % part["name"])
+        tab = part["table"]
+        for i in range(0, len(tab), 8):
+            c.append("    " + " ".join("%7d," % v for v in tab[i:i + 8]))
+        c.append("};")
+    c.append("")
+    c.append("const int32_t *const thermistor_tables[THERMISTOR_PART_NUM] = {")
+    for part in parts:
+        c.append("    s_table_%s," % part["name"])
+    c.append("};")
+
+    os.makedirs(args.out_dir, exist_ok=True)
+    write_file(os.path.join(args.out_dir, "thermistor_parts.h"), "\n".join(h) + "\n")
+    write_file(os.path.join(args.out_dir, "thermistor_tables.c"), "\n".join(c) + "\n")
+
+    for part in parts:
+        print("ntc table %s: %d entries, max error %.2f C in %g..%g C%s" % (
+            part["name"], size, part["err"] / 100.0, args.err_lo, args.err_hi,
+            " (default)" if part is default else ""))
+
+
+if __name__ == "__main__":
+    main()